@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Stream.h>
+
+#include <cstring>
+#include <vector>
+
+// In-memory Stream for benchmarks: reads drain `rx`, writes append to `tx`.
+// Avoids the per-call cost of the ArduinoFake mocks so the numbers reflect
+// the protocol code rather than the test double.
+class LoopbackStream : public Stream
+{
+public:
+    std::vector<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    size_t rxIndex = 0;
+
+    void load(const std::vector<uint8_t>& bytes)
+    {
+        rx = bytes;
+        rxIndex = 0;
+    }
+
+    int available() override
+    {
+        return static_cast<int>(rx.size() - rxIndex);
+    }
+
+    int read() override
+    {
+        if (rxIndex >= rx.size())
+        {
+            return -1;
+        }
+        return rx[rxIndex++];
+    }
+
+    int peek() override
+    {
+        if (rxIndex >= rx.size())
+        {
+            return -1;
+        }
+        return rx[rxIndex];
+    }
+
+    size_t readBytes(char* buffer, size_t length)
+    {
+        size_t count = rx.size() - rxIndex;
+        if (length < count)
+        {
+            count = length;
+        }
+        memcpy(buffer, rx.data() + rxIndex, count);
+        rxIndex += count;
+        return count;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length)
+    {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+
+    size_t write(uint8_t value) override
+    {
+        tx.push_back(value);
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        tx.insert(tx.end(), buffer, buffer + size);
+        return size;
+    }
+
+    int availableForWrite() override
+    {
+        return 1 << 16;
+    }
+
+    void flush() override
+    {
+    }
+};
@@ -0,0 +1,66 @@
+#include <unity.h>
+
+#include <chrono>
+#include <vector>
+
+#include "CRC.h"
+
+static const size_t BENCH_CRC_BYTES = 4 * 1024 * 1024;
+static const int BENCH_CRC_ROUNDS = 8;
+
+// Run `fn` over the buffer in `block` sized pieces, one CRC per piece as
+// the framing layer does. Returns MB/s.
+template<typename Fn>
+static double runCrc(const std::vector<uint8_t>& data, size_t block, Fn fn, uint32_t& sink)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_CRC_ROUNDS; ++round)
+    {
+        for (size_t offset = 0; offset + block <= data.size(); offset += block)
+        {
+            sink ^= fn(&data[offset], block);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return data.size() * static_cast<double>(BENCH_CRC_ROUNDS) / std::chrono::duration<double>(elapsed).count() / 1e6;
+}
+
+template<typename Engine>
+static void benchEngine(const char* name, const std::vector<uint8_t>& data, size_t block)
+{
+    uint32_t bytewise = 0;
+    uint32_t slice4 = 0;
+    uint32_t slice8 = 0;
+    double bytewiseRate = runCrc(data, block, [](const uint8_t* p, size_t n) { return Engine::calculate(p, n); }, bytewise);
+    double slice4Rate = runCrc(data, block, [](const uint8_t* p, size_t n) { return Engine::template calculateSliced<4>(p, n); }, slice4);
+    double slice8Rate = runCrc(data, block, [](const uint8_t* p, size_t n) { return Engine::template calculateSliced<8>(p, n); }, slice8);
+    printf("%-12s %5zuB  x1 %8.1f MB/s  x4 %8.1f MB/s  x8 %8.1f MB/s\n", name, block, bytewiseRate, slice4Rate, slice8Rate);
+    TEST_ASSERT_EQUAL_HEX32(bytewise, slice4);
+    TEST_ASSERT_EQUAL_HEX32(bytewise, slice8);
+}
+
+// Byte-wise vs slicing-by-4/8 for each width, at a typical frame payload
+// and at a bulk block size
+void bench_crc_variants(void)
+{
+    std::vector<uint8_t> data(BENCH_CRC_BYTES);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 131 + (i >> 8));
+    }
+
+    for (size_t block : {static_cast<size_t>(32), static_cast<size_t>(4096)})
+    {
+        benchEngine<Crc8>("CRC-8", data, block);
+        benchEngine<Crc16Ccitt>("CRC-16/CCITT", data, block);
+        benchEngine<Crc32>("CRC-32", data, block);
+        benchEngine<Crc32C>("CRC-32C", data, block);
+    }
+}
+
+int bench_crc_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_crc_variants);
+    return UNITY_END();
+}
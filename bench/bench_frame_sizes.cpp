@@ -0,0 +1,126 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "ProtoFrameImpl.h"
+#include "LoopbackStream.h"
+
+// Room for 1KiB payloads, which need the Varint format
+using BenchLargeFrameConfig = ProtoFrameConfig<1100, RING_BUFFER_SIZE, 256>;
+template class BasicProtoFrame<BenchLargeFrameConfig>;
+
+static const size_t BENCH_FRAME_BYTES = 4 * 1024 * 1024;
+
+// A valid command padded with an unknown bytes field (skipped by the
+// decoder) so the payload is exactly `size` bytes
+static std::vector<uint8_t> buildPayload(uint32_t id, size_t size)
+{
+    uint8_t buffer[16];
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = id;
+    pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    pb_encode(&stream, C110PCommand_fields, &msg);
+
+    std::vector<uint8_t> payload(buffer, buffer + stream.bytes_written);
+    const uint8_t PAD_TAG = (15 << 3) | 2;
+    size_t pad = size - payload.size() - 1 - Varint::encodedSize(size);
+    pad = size - payload.size() - 1 - Varint::encodedSize(pad);
+    uint8_t padLength[Varint::MAX_BYTES];
+    payload.push_back(PAD_TAG);
+    payload.insert(payload.end(), padLength, padLength + Varint::encode(pad, padLength));
+    payload.resize(size, 0x55);
+    return payload;
+}
+
+static std::vector<uint8_t> buildFrames(size_t payloadSize, ProtoFrameFormat format, size_t& count)
+{
+    std::vector<uint8_t> bytes;
+    count = 0;
+    while (bytes.size() < BENCH_FRAME_BYTES)
+    {
+        std::vector<uint8_t> payload = buildPayload(static_cast<uint32_t>(++count), payloadSize);
+        bytes.push_back(static_cast<uint8_t>(ProtoFrame::START_BYTE));
+        if (format == ProtoFrameFormat::Varint)
+        {
+            uint8_t length[Varint::MAX_BYTES];
+            bytes.insert(bytes.end(), length, length + Varint::encode(payload.size(), length));
+        }
+        else
+        {
+            bytes.push_back(static_cast<uint8_t>(payload.size()));
+        }
+        bytes.insert(bytes.end(), payload.begin(), payload.end());
+        bytes.push_back(crc8.calculate(payload.data(), payload.size()));
+    }
+    return bytes;
+}
+
+static double runReadFrame(const std::vector<uint8_t>& bytes, ProtoFrameFormat format, bool chunked,
+                           size_t& frames, uint32_t& lastId)
+{
+    LoopbackStream stream;
+    stream.load(bytes);
+    BasicProtoFrame<BenchLargeFrameConfig> protoFrame(&stream);
+    protoFrame.setFrameFormat(format);
+    protoFrame.setChunkedRead(chunked);
+    protoFrame.setTickProvider([]() -> uint32_t { return 0; });
+
+    std::streambuf* coutBuffer = std::cout.rdbuf(nullptr);
+    auto start = std::chrono::steady_clock::now();
+    frames = 0;
+    while (stream.available() || protoFrame.m_rxStageHead < protoFrame.m_rxStageTail)
+    {
+        if (protoFrame.readFrame())
+        {
+            frames++;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout.rdbuf(coutBuffer);
+    std::cout.clear();
+    lastId = protoFrame.getLastReceivedMessage().id;
+
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+// Throughput by payload size; StartLength tops out at 255 byte payloads
+void bench_frame_sizes_throughput(void)
+{
+    struct {
+        const char* name;
+        ProtoFrameFormat format;
+        size_t payloadSize;
+    } cases[] = {
+        {"StartLength 64B", ProtoFrameFormat::StartLength, 64},
+        {"Varint 64B", ProtoFrameFormat::Varint, 64},
+        {"Varint 256B", ProtoFrameFormat::Varint, 256},
+        {"Varint 1KiB", ProtoFrameFormat::Varint, 1024},
+    };
+
+    for (const auto& c : cases)
+    {
+        size_t count = 0;
+        std::vector<uint8_t> bytes = buildFrames(c.payloadSize, c.format, count);
+        for (bool chunked : {false, true})
+        {
+            size_t frames = 0;
+            uint32_t lastId = 0;
+            double seconds = runReadFrame(bytes, c.format, chunked, frames, lastId);
+            printf("%-16s %-8s %8.1f MB/s %9.0f frames/sec\n", c.name, chunked ? "chunked" : "per-byte",
+                   bytes.size() / seconds / 1e6, frames / seconds);
+            TEST_ASSERT_EQUAL(count, frames);
+            // Every payload decoded, not just framed
+            TEST_ASSERT_EQUAL(count, lastId);
+        }
+    }
+}
+
+int bench_frame_sizes_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_frame_sizes_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const size_t BENCH_FRAME_COUNT = 20000;
+static const double BENCH_ERROR_RATE = 0.05;
+
+static std::vector<bool> s_received;
+
+struct FramedStream {
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> offsets; // start of each frame in bytes
+};
+
+// Encode LED commands through C110PSerial so the sender side framing is used
+static FramedStream buildFrames(ProtoFrame::FrameFormat format, size_t count)
+{
+    LoopbackStream out;
+    C110PSerial sender(&out);
+    sender.setFrameFormat(format);
+    // Nothing is ever ACKed here, so the send window is off
+    sender.setSendWindow(0);
+
+    FramedStream framed;
+    for (size_t i = 0; i < count; ++i)
+    {
+        C110PCommand msg = sender.createLedCommand(C110PRegion_REGION_DOME, static_cast<uint32_t>(i), 0xAA00AA, 0);
+        msg.id = static_cast<uint32_t>(i + 1);
+        framed.offsets.push_back(out.tx.size());
+        sender.send(msg);
+    }
+    framed.bytes = out.tx;
+    return framed;
+}
+
+// Flip one random bit in a fraction of the frames, returning which were hit
+static std::vector<bool> injectBitErrors(FramedStream& framed, double rate)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<bool> corrupted(framed.offsets.size(), false);
+    for (size_t i = 0; i < framed.offsets.size(); ++i)
+    {
+        if (chance(rng) >= rate)
+        {
+            continue;
+        }
+        size_t end = (i + 1 < framed.offsets.size()) ? framed.offsets[i + 1] : framed.bytes.size();
+        size_t index = framed.offsets[i] + rng() % (end - framed.offsets[i]);
+        framed.bytes[index] ^= static_cast<uint8_t>(1u << (rng() % 8));
+        corrupted[i] = true;
+    }
+    return corrupted;
+}
+
+static double receiveAll(ProtoFrame::FrameFormat format, const std::vector<uint8_t>& bytes)
+{
+    LoopbackStream in;
+    in.load(bytes);
+    ProtoFrame receiver(&in);
+    receiver.setFrameFormat(format);
+    receiver.setChunkedRead(true);
+    receiver.setLedCallback([](const C110PCommand_data_led_MSGTYPE& led) {
+        if (led.start < s_received.size())
+        {
+            s_received[led.start] = true;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    while (in.available() || receiver.m_rxStageHead < receiver.m_rxStageTail)
+    {
+        receiver.readFrame();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+static void benchFormat(const char* name, ProtoFrame::FrameFormat format)
+{
+    FramedStream framed = buildFrames(format, BENCH_FRAME_COUNT);
+
+    s_received.assign(BENCH_FRAME_COUNT, false);
+    double seconds = receiveAll(format, framed.bytes);
+    size_t clean = 0;
+    for (bool r : s_received)
+    {
+        clean += r ? 1 : 0;
+    }
+    printf("%-12s clean: %zu bytes, %zu/%zu frames, %.0f bytes/sec\n",
+           name, framed.bytes.size(), clean, BENCH_FRAME_COUNT, framed.bytes.size() / seconds);
+    TEST_ASSERT_EQUAL(BENCH_FRAME_COUNT, clean);
+
+    std::vector<bool> corrupted = injectBitErrors(framed, BENCH_ERROR_RATE);
+    s_received.assign(BENCH_FRAME_COUNT, false);
+    seconds = receiveAll(format, framed.bytes);
+
+    // Intact frames that were still lost were swallowed while resyncing
+    size_t errors = 0;
+    size_t collateral = 0;
+    size_t collateralBytes = 0;
+    for (size_t i = 0; i < BENCH_FRAME_COUNT; ++i)
+    {
+        if (corrupted[i])
+        {
+            errors++;
+        }
+        else if (!s_received[i])
+        {
+            size_t end = (i + 1 < framed.offsets.size()) ? framed.offsets[i + 1] : framed.bytes.size();
+            collateral++;
+            collateralBytes += end - framed.offsets[i];
+        }
+    }
+    printf("%-12s %.0f%% bit errors: %zu corrupted, %zu intact frames lost (%.2f bytes/error to resync), %.0f bytes/sec\n",
+           name, BENCH_ERROR_RATE * 100, errors, collateral,
+           errors ? static_cast<double>(collateralBytes) / errors : 0.0, framed.bytes.size() / seconds);
+}
+
+void bench_framing_start_length(void)
+{
+    benchFormat("StartLength", ProtoFrame::FrameFormat::StartLength);
+}
+
+void bench_framing_cobs(void)
+{
+    benchFormat("Cobs", ProtoFrame::FrameFormat::Cobs);
+}
+
+int bench_framing_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_framing_start_length);
+    RUN_TEST(bench_framing_cobs);
+    return UNITY_END();
+}
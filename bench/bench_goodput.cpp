@@ -0,0 +1,134 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <vector>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const uint32_t BENCH_GOODPUT_MS = 20000;
+static const uint32_t BENCH_GOODPUT_BAUD = 115200;
+
+static uint32_t s_now = 0;
+static size_t s_delivered = 0;
+
+static uint64_t benchNow()
+{
+    return s_now;
+}
+
+static void countDelivered(const LedCommand&)
+{
+    s_delivered++;
+}
+
+// Hands everything `from` has written to `to`, as a wire would
+static void carry(LoopbackStream& from, LoopbackStream& to)
+{
+    if (to.rxIndex == to.rx.size())
+    {
+        to.rx.clear();
+        to.rxIndex = 0;
+    }
+    to.rx.insert(to.rx.end(), from.tx.begin(), from.tx.end());
+    from.tx.clear();
+}
+
+enum class AckMode : uint8_t {
+    PerMessage,
+    Coalesced,
+    Piggyback
+};
+
+static void setAckMode(C110PSerial& link, AckMode mode)
+{
+    if (mode == AckMode::Coalesced)
+    {
+        link.setAckCoalescing(10, 8);
+    }
+    else if (mode == AckMode::Piggyback)
+    {
+        link.setAckCoalescing(10, 1);
+        link.setPiggybackAcks(true);
+    }
+}
+
+// Two ends of one link, both sending LED commands on a simulated
+// millisecond clock: body every millisecond, dome every `domeEvery`.
+// Goodput is the commands delivered per second, both ways together, that
+// the busier side's bytes on the wire would allow at BENCH_GOODPUT_BAUD
+static void benchGoodput(const char* name, AckMode mode, uint32_t domeEvery)
+{
+    LoopbackStream bodyWire;
+    LoopbackStream domeWire;
+    C110PSerial body(&bodyWire, C110PRegion_REGION_BODY);
+    C110PSerial dome(&domeWire, C110PRegion_REGION_DOME);
+    size_t sent = 0;
+    s_delivered = 0;
+    s_now = 1000;
+    for (C110PSerial* link : {&body, &dome})
+    {
+        link->setTimestampProvider(&benchNow);
+        link->setChunkedRead(true);
+        link->setDrainBudget(SIZE_MAX);
+        link->setLedCallback(&countDelivered);
+        setAckMode(*link, mode);
+    }
+
+    size_t bodyBytes = 0;
+    size_t domeBytes = 0;
+    for (uint32_t ms = 0; ms < BENCH_GOODPUT_MS; ++ms, ++s_now)
+    {
+        body.send(body.createLedCommand(C110PRegion_REGION_DOME, ms, 0xAA00AA));
+        sent++;
+        if (ms % domeEvery == 0)
+        {
+            dome.send(dome.createLedCommand(C110PRegion_REGION_BODY, ms, 0x00AA00));
+            sent++;
+        }
+        bodyBytes += bodyWire.tx.size();
+        domeBytes += domeWire.tx.size();
+        carry(bodyWire, domeWire);
+        carry(domeWire, bodyWire);
+        body.processQueue();
+        dome.processQueue();
+    }
+    // Let the last ACKs out
+    s_now += 20;
+    for (int round = 0; round < 3; ++round)
+    {
+        body.processQueue();
+        dome.processQueue();
+        bodyBytes += bodyWire.tx.size();
+        domeBytes += domeWire.tx.size();
+        carry(bodyWire, domeWire);
+        carry(domeWire, bodyWire);
+    }
+
+    size_t wireBytes = bodyBytes > domeBytes ? bodyBytes : domeBytes;
+    double seconds = wireBytes * 10.0 / BENCH_GOODPUT_BAUD;
+    printf("%-10s body:dome %u:1  %5.1f B/cmd  busiest side %7zu B  goodput %6.0f cmd/s at %u baud\n",
+           name, domeEvery, static_cast<double>(bodyBytes + domeBytes) / sent, wireBytes,
+           sent / seconds, BENCH_GOODPUT_BAUD);
+    // Everything arrives once and is acknowledged, so nothing is retried
+    TEST_ASSERT_EQUAL(sent, s_delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, body.getUnacknowledgedMessagesSize());
+    TEST_ASSERT_EQUAL_UINT32(0, dome.getUnacknowledgedMessagesSize());
+}
+
+void bench_goodput_bidirectional(void)
+{
+    for (uint32_t domeEvery : {1u, 4u})
+    {
+        benchGoodput("per-msg", AckMode::PerMessage, domeEvery);
+        benchGoodput("coalesced", AckMode::Coalesced, domeEvery);
+        benchGoodput("piggyback", AckMode::Piggyback, domeEvery);
+    }
+}
+
+int bench_goodput_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_goodput_bidirectional);
+    return UNITY_END();
+}
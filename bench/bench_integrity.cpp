@@ -0,0 +1,75 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <vector>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const size_t BENCH_INTEGRITY_FRAMES = 20000;
+
+static size_t s_integrityReceived = 0;
+
+// Per-frame cost of each integrity mode: encoding and framing in send(),
+// then parsing and verifying in readFrame()
+static void benchIntegrity(const char* name, ProtoFrame::Integrity integrity, ProtoFrame::FrameFormat format)
+{
+    LoopbackStream out;
+    C110PSerial sender(&out, C110PRegion_REGION_UNSPECIFIED, 1000, integrity);
+    sender.setFrameFormat(format);
+    // Nothing is ever ACKed here, so the send window is off
+    sender.setSendWindow(0);
+    std::vector<C110PCommand> messages;
+    for (size_t i = 0; i < BENCH_INTEGRITY_FRAMES; ++i)
+    {
+        C110PCommand msg = sender.createLedCommand(C110PRegion_REGION_DOME, static_cast<uint32_t>(i), 0xAA00AA, 0);
+        msg.id = static_cast<uint32_t>(i + 1);
+        messages.push_back(msg);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const C110PCommand& msg : messages)
+    {
+        sender.send(msg);
+    }
+    double sendSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LoopbackStream in;
+    in.load(out.tx);
+    ProtoFrame receiver(&in, C110PRegion_REGION_UNSPECIFIED, 1000, 3, integrity);
+    receiver.setFrameFormat(format);
+    receiver.setChunkedRead(true);
+    receiver.setLedCallback([](const C110PCommand_data_led_MSGTYPE&) { s_integrityReceived++; });
+    s_integrityReceived = 0;
+
+    start = std::chrono::steady_clock::now();
+    while (in.available() || receiver.m_rxStageHead < receiver.m_rxStageTail)
+    {
+        receiver.readFrame();
+    }
+    double receiveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-8s %-12s %6.1f bytes/frame  send %6.1f ns/frame  receive %6.1f ns/frame\n",
+           name, format == ProtoFrame::FrameFormat::Cobs ? "Cobs" : "StartLength",
+           static_cast<double>(out.tx.size()) / BENCH_INTEGRITY_FRAMES,
+           sendSeconds * 1e9 / BENCH_INTEGRITY_FRAMES, receiveSeconds * 1e9 / BENCH_INTEGRITY_FRAMES);
+    TEST_ASSERT_EQUAL(BENCH_INTEGRITY_FRAMES, s_integrityReceived);
+}
+
+void bench_integrity_per_frame_cost(void)
+{
+    for (ProtoFrame::FrameFormat format : {ProtoFrame::FrameFormat::StartLength, ProtoFrame::FrameFormat::Cobs})
+    {
+        benchIntegrity("CRC-8", ProtoFrame::Integrity::Crc8, format);
+        benchIntegrity("CRC-16", ProtoFrame::Integrity::Crc16, format);
+        benchIntegrity("CRC-32C", ProtoFrame::Integrity::Crc32C, format);
+    }
+}
+
+int bench_integrity_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_integrity_per_frame_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,44 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+
+extern int bench_readframe_suite();
+extern int bench_framing_suite();
+extern int bench_frame_sizes_suite();
+extern int bench_crc_suite();
+extern int bench_integrity_suite();
+extern int bench_ringbuffer_suite();
+extern int bench_retransmit_suite();
+extern int bench_retry_suite();
+extern int bench_goodput_suite();
+extern int bench_qos_suite();
+extern int bench_txqueue_suite();
+
+void setUp(void)
+{
+    ArduinoFakeReset();
+}
+
+void tearDown(void) 
+{
+
+};
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    bench_readframe_suite();
+    bench_framing_suite();
+    bench_frame_sizes_suite();
+    bench_crc_suite();
+    bench_integrity_suite();
+    bench_ringbuffer_suite();
+    bench_retransmit_suite();
+    bench_retry_suite();
+    bench_goodput_suite();
+    bench_qos_suite();
+    bench_txqueue_suite();
+
+    return UNITY_END();
+}
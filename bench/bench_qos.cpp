@@ -0,0 +1,99 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const size_t BENCH_QOS_MESSAGES = 100000;
+
+static uint32_t s_qosNow = 0;
+static size_t s_qosDelivered = 0;
+
+static uint64_t qosNow()
+{
+    return s_qosNow;
+}
+
+static void countMoves(const MoveCommand&)
+{
+    s_qosDelivered++;
+}
+
+static void qosCarry(LoopbackStream& from, LoopbackStream& to)
+{
+    if (to.rxIndex == to.rx.size())
+    {
+        to.rx.clear();
+        to.rxIndex = 0;
+    }
+    to.rx.insert(to.rx.end(), from.tx.begin(), from.tx.end());
+    from.tx.clear();
+}
+
+// A MoveCommand stream from body to dome over a loopback pair, as fast as
+// the class allows: reliable commands wait for the send window and are
+// ACKed, best-effort ones are written and forgotten
+static void benchQos(const char* name, C110PQos qos)
+{
+    LoopbackStream bodyWire;
+    LoopbackStream domeWire;
+    C110PSerial body(&bodyWire, C110PRegion_REGION_BODY);
+    C110PSerial dome(&domeWire, C110PRegion_REGION_DOME);
+    s_qosNow = 1000;
+    s_qosDelivered = 0;
+    for (C110PSerial* link : {&body, &dome})
+    {
+        link->setTimestampProvider(&qosNow);
+        link->setChunkedRead(true);
+        link->setDrainBudget(SIZE_MAX);
+    }
+    dome.setMoveCallback(&countMoves);
+    body.setQos(C110PCommand_move_tag, qos);
+
+    size_t sent = 0;
+    size_t bodyBytes = 0;
+    size_t domeBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (s_qosDelivered < BENCH_QOS_MESSAGES)
+    {
+        while (sent < BENCH_QOS_MESSAGES)
+        {
+            C110PCommand cmd = body.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK,
+                                                      static_cast<uint32_t>(sent), 90);
+            cmd.id = static_cast<uint32_t>(sent + 1);
+            if (body.trySend(cmd) == C110PSerial::SendStatus::WouldBlock)
+            {
+                break;
+            }
+            sent++;
+        }
+        bodyBytes += bodyWire.tx.size();
+        qosCarry(bodyWire, domeWire);
+        dome.processQueue();
+        domeBytes += domeWire.tx.size();
+        qosCarry(domeWire, bodyWire);
+        body.processQueue();
+        s_qosNow++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-12s %9.0f msgs/sec  %5.1f B/msg out  %5.1f B/msg back\n", name, BENCH_QOS_MESSAGES / seconds,
+           static_cast<double>(bodyBytes) / BENCH_QOS_MESSAGES, static_cast<double>(domeBytes) / BENCH_QOS_MESSAGES);
+    TEST_ASSERT_EQUAL(BENCH_QOS_MESSAGES, s_qosDelivered);
+    TEST_ASSERT_EQUAL_UINT32(0, body.getUnacknowledgedMessagesSize());
+}
+
+void bench_qos_loopback_rate(void)
+{
+    benchQos("reliable", C110PQos_QOS_RELIABLE);
+    benchQos("best-effort", C110PQos_QOS_BEST_EFFORT);
+}
+
+int bench_qos_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_qos_loopback_rate);
+    return UNITY_END();
+}
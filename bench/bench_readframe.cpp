@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "ProtoFrame.h"
+#include "LoopbackStream.h"
+
+static const size_t BENCH_FRAME_COUNT = 20000;
+
+// Build a stream of valid LED command frames with unique ids
+static std::vector<uint8_t> buildFrames(size_t count)
+{
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        C110PCommand msg = C110PCommand_init_zero;
+        msg.id = static_cast<uint32_t>(i + 1);
+        msg.which_data = C110PCommand_led_tag;
+        msg.data.led.start = static_cast<uint32_t>(i);
+        msg.data.led.end = static_cast<uint32_t>(i + 100);
+        msg.data.led.duration = 250;
+
+        uint8_t buffer[ProtoFrame::MAX_SIZE];
+        pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+        pb_encode(&stream, C110PCommand_fields, &msg);
+        bytes.push_back(static_cast<uint8_t>(ProtoFrame::START_BYTE));
+        bytes.push_back(static_cast<uint8_t>(stream.bytes_written));
+        bytes.insert(bytes.end(), buffer, buffer + stream.bytes_written);
+        bytes.push_back(crc8.calculate(buffer, stream.bytes_written));
+    }
+    return bytes;
+}
+
+static uint32_t s_tick = 0;
+
+static uint32_t benchTick()
+{
+    return s_tick;
+}
+
+static double runReadFrame(const std::vector<uint8_t>& bytes, bool chunked, size_t& frames,
+                           uint32_t (*tick)() = nullptr, size_t tickInterval = 32)
+{
+    LoopbackStream stream;
+    stream.load(bytes);
+    ProtoFrame protoFrame(&stream);
+    protoFrame.setChunkedRead(chunked);
+    protoFrame.setTickProvider(tick, tickInterval);
+
+    // Silence the debug output so only the parser is measured
+    std::streambuf* coutBuffer = std::cout.rdbuf(nullptr);
+    auto start = std::chrono::steady_clock::now();
+    frames = 0;
+    while (stream.available() || protoFrame.m_rxStageHead < protoFrame.m_rxStageTail)
+    {
+        if (protoFrame.readFrame())
+        {
+            frames++;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout.rdbuf(coutBuffer);
+    std::cout.clear();
+
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+void bench_readFrame_byte_vs_chunked(void)
+{
+    std::vector<uint8_t> bytes = buildFrames(BENCH_FRAME_COUNT);
+
+    size_t byteFrames = 0;
+    size_t chunkedFrames = 0;
+    double byteSeconds = runReadFrame(bytes, false, byteFrames);
+    double chunkedSeconds = runReadFrame(bytes, true, chunkedFrames);
+
+    printf("readFrame per-byte: %zu frames, %zu bytes, %.0f bytes/sec\n",
+           byteFrames, bytes.size(), bytes.size() / byteSeconds);
+    printf("readFrame chunked:  %zu frames, %zu bytes, %.0f bytes/sec\n",
+           chunkedFrames, bytes.size(), bytes.size() / chunkedSeconds);
+    printf("speedup: %.2fx\n", byteSeconds / chunkedSeconds);
+
+    TEST_ASSERT_EQUAL(BENCH_FRAME_COUNT, byteFrames);
+    TEST_ASSERT_EQUAL(BENCH_FRAME_COUNT, chunkedFrames);
+}
+
+// Per-byte parse cost depending on how often the read loop looks at the clock
+void bench_readFrame_clock_checks(void)
+{
+    std::vector<uint8_t> bytes = buildFrames(BENCH_FRAME_COUNT);
+    struct {
+        const char* name;
+        bool chunked;
+        uint32_t (*tick)();
+        size_t interval;
+    } cases[] = {
+        {"per-byte, clock every byte", false, nullptr, 1},
+        {"per-byte, clock every 32", false, nullptr, 32},
+        {"per-byte, cheap tick every 32", false, benchTick, 32},
+        {"chunked, clock every byte", true, nullptr, 1},
+        {"chunked, cheap tick every 32", true, benchTick, 32},
+    };
+
+    for (const auto& c : cases)
+    {
+        size_t frames = 0;
+        double seconds = runReadFrame(bytes, c.chunked, frames, c.tick, c.interval);
+        printf("%-30s %.2f ns/byte\n", c.name, seconds * 1e9 / bytes.size());
+        TEST_ASSERT_EQUAL(BENCH_FRAME_COUNT, frames);
+    }
+}
+
+int bench_readframe_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_readFrame_byte_vs_chunked);
+    RUN_TEST(bench_readFrame_clock_checks);
+    return UNITY_END();
+}
@@ -0,0 +1,83 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <vector>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const size_t BENCH_RETRANSMIT_ROUNDS = 2000;
+
+// Cost of one retransmit: a write() of the cached frame, against encoding
+// and framing the message again as retries used to do through send()
+static void benchRetransmit(const char* name, ProtoFrame::Integrity integrity, ProtoFrame::FrameFormat format)
+{
+    LoopbackStream out;
+    ProtoFrame frame(&out, C110PRegion_REGION_BODY, 1000, 3, integrity);
+    frame.setFrameFormat(format);
+    std::vector<C110PCommand> messages;
+    for (uint32_t i = 0; i < ProtoFrameConfigDefault::RING_DEPTH; ++i)
+    {
+        C110PCommand msg = C110PCommand_init_zero;
+        msg.id = 1700000000u + i;
+        msg.source = C110PRegion_REGION_BODY;
+        msg.target = C110PRegion_REGION_DOME;
+        msg.which_data = C110PCommand_led_tag;
+        msg.data.led.start = i;
+        msg.data.led.end = 0xAA00AA;
+        frame.writeFrame(frame.encodeFrame(msg));
+        messages.push_back(msg);
+    }
+    out.tx.reserve(out.tx.size() * (BENCH_RETRANSMIT_ROUNDS + 1) * 2);
+
+    size_t before = out.tx.size();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < BENCH_RETRANSMIT_ROUNDS; ++round)
+    {
+        for (const C110PCommand& msg : messages)
+        {
+            frame.resendMessage(msg.id);
+        }
+    }
+    double cachedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t cachedBytes = out.tx.size() - before;
+
+    before = out.tx.size();
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < BENCH_RETRANSMIT_ROUNDS; ++round)
+    {
+        for (const C110PCommand& msg : messages)
+        {
+            frame.writeFrame(frame.encodeFrame(msg));
+        }
+    }
+    double encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t encodeBytes = out.tx.size() - before;
+
+    size_t retries = BENCH_RETRANSMIT_ROUNDS * messages.size();
+    printf("%-8s %-12s cached %6.1f ns/retry  re-encode %6.1f ns/retry\n",
+           name, format == ProtoFrame::FrameFormat::Cobs ? "Cobs" : "StartLength",
+           cachedSeconds * 1e9 / retries, encodeSeconds * 1e9 / retries);
+    // Every frame held, and byte for byte the same either way
+    TEST_ASSERT_EQUAL(messages.size(), frame.sentFrames().size());
+    TEST_ASSERT_EQUAL(encodeBytes, cachedBytes);
+}
+
+void bench_retransmit_per_retry_cost(void)
+{
+    for (ProtoFrame::FrameFormat format : {ProtoFrame::FrameFormat::StartLength, ProtoFrame::FrameFormat::Cobs})
+    {
+        benchRetransmit("CRC-8", ProtoFrame::Integrity::Crc8, format);
+        benchRetransmit("CRC-32C", ProtoFrame::Integrity::Crc32C, format);
+    }
+    printf("sent history: %zu bytes as frames, %zu bytes as C110PCommand structs\n",
+           sizeof(ProtoFrame::SentFrames), sizeof(RingBuffer<C110PCommand, ProtoFrameConfigDefault::RING_DEPTH>));
+}
+
+int bench_retransmit_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_retransmit_per_retry_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "RingBuffer.h"
+#include "c110p_serial.pb.h"
+
+// Heap allocations made while a measured loop runs
+static size_t s_allocations = 0;
+
+void* operator new(size_t size)
+{
+    s_allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// The previous index, kept here as the reference: an unordered_map of held
+// ids beside the ring, with get() scanning the ring
+template<typename T, size_t N>
+class MapRingBuffer
+{
+public:
+    void add(const T& message)
+    {
+        if (contains(message.id))
+        {
+            return;
+        }
+        if (m_size < N)
+        {
+            ++m_size;
+        }
+        else
+        {
+            m_messageMap.erase(m_buffer[m_tail].id);
+            m_tail = (m_tail + 1) % N;
+        }
+        m_buffer[m_head] = message;
+        m_messageMap[message.id] = true;
+        m_head = (m_head + 1) % N;
+    }
+
+    bool contains(uint32_t id) const
+    {
+        return m_messageMap.find(id) != m_messageMap.end();
+    }
+
+    T* get(uint32_t id)
+    {
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            size_t idx = (m_tail + i) % N;
+            if (m_buffer[idx].id == id)
+            {
+                return &m_buffer[idx];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    T m_buffer[N];
+    size_t m_head = 0;
+    size_t m_tail = 0;
+    size_t m_size = 0;
+    std::unordered_map<uint32_t, bool> m_messageMap;
+};
+
+static const size_t BENCH_RING_OPS = 200000;
+
+template<typename Fn>
+static double nsPerOp(size_t ops, Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+// add() in steady state (every add evicts), contains() hit and miss, and
+// get() by id, with ids spaced like millisecond timestamps
+template<typename Ring, size_t N>
+static void benchRing(const char* name)
+{
+    Ring* ring = new Ring();
+    C110PCommand msg = C110PCommand_init_zero;
+    uint32_t id = 1000;
+    for (size_t i = 0; i < N; ++i)
+    {
+        msg.id = (id += 7);
+        ring->add(msg);
+    }
+
+    size_t found = 0;
+    s_allocations = 0;
+    double addNs = nsPerOp(BENCH_RING_OPS, [&]() {
+        for (size_t i = 0; i < BENCH_RING_OPS; ++i)
+        {
+            msg.id = (id += 7);
+            ring->add(msg);
+        }
+    });
+    size_t addAllocations = s_allocations;
+
+    // Ids of the messages held now, oldest first
+    uint32_t oldest = id - 7 * (N - 1);
+    size_t lookups = BENCH_RING_OPS < 4 * N ? 4 * N : BENCH_RING_OPS;
+    s_allocations = 0;
+    double hitNs = nsPerOp(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            found += ring->contains(oldest + 7 * static_cast<uint32_t>((i * 13) % N));
+        }
+    });
+    double missNs = nsPerOp(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            found += ring->contains(oldest + 7 * static_cast<uint32_t>((i * 13) % N) + 3);
+        }
+    });
+    double getNs = nsPerOp(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            found += ring->get(oldest + 7 * static_cast<uint32_t>((i * 13) % N)) != nullptr;
+        }
+    });
+    size_t lookupAllocations = s_allocations;
+
+    printf("%-14s depth %5zu  add %7.1f ns  contains hit %6.1f ns  miss %6.1f ns  get %8.1f ns  allocs add %zu lookup %zu\n",
+           name, N, addNs, hitNs, missNs, getNs, addAllocations, lookupAllocations);
+    TEST_ASSERT_EQUAL(2 * lookups, found);
+    delete ring;
+}
+
+void bench_ringbuffer_operations(void)
+{
+    benchRing<RingBuffer<C110PCommand, 25>, 25>("RingBuffer");
+    benchRing<MapRingBuffer<C110PCommand, 25>, 25>("unordered_map");
+    benchRing<RingBuffer<C110PCommand, 256>, 256>("RingBuffer");
+    benchRing<MapRingBuffer<C110PCommand, 256>, 256>("unordered_map");
+    benchRing<RingBuffer<C110PCommand, 4096>, 4096>("RingBuffer");
+    benchRing<MapRingBuffer<C110PCommand, 4096>, 4096>("unordered_map");
+}
+
+int bench_ringbuffer_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_ringbuffer_operations);
+    return UNITY_END();
+}
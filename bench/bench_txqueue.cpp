@@ -0,0 +1,209 @@
+#include <unity.h>
+#include <Arduino.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "C110PSerial.h"
+#include "LoopbackStream.h"
+
+static const uint32_t BENCH_TXQUEUE_MS = 20000;
+static const uint32_t BENCH_TXQUEUE_BAUD = 115200;
+static const size_t BENCH_TXQUEUE_UART_BUFFER = 64;  // HardwareSerial's TX buffer
+
+static uint32_t s_txNow = 0;
+static std::vector<uint32_t> s_latency[static_cast<size_t>(C110PTxClass::Sound) + 1];
+
+static uint64_t txNow()
+{
+    return s_txNow;
+}
+
+// Each command carries the millisecond it was made in a payload field
+static void latencyOf(C110PTxClass cls, uint32_t created)
+{
+    s_latency[static_cast<size_t>(cls)].push_back(s_txNow - created);
+}
+
+static void onMove(const MoveCommand& move)
+{
+    latencyOf(move.y == 1 ? C110PTxClass::Emergency : C110PTxClass::Move, move.x);
+}
+
+static void onLed(const LedCommand& led)
+{
+    latencyOf(C110PTxClass::Led, led.start);
+}
+
+static void onSound(const SoundCommand& sound)
+{
+    latencyOf(C110PTxClass::Sound, sound.id);
+}
+
+// A UART: availableForWrite() is what is left of its TX buffer, which
+// empties onto the wire at the baud rate of the simulated clock
+class PacedStream : public LoopbackStream
+{
+public:
+    int availableForWrite() override
+    {
+        return static_cast<int>(BENCH_TXQUEUE_UART_BUFFER - tx.size());
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        // A blocking write would wait for room; here it only counts it
+        if (tx.size() + size > BENCH_TXQUEUE_UART_BUFFER)
+        {
+            overruns++;
+        }
+        return LoopbackStream::write(buffer, size);
+    }
+
+    // One millisecond of the wire, handed to `to`
+    void tick(LoopbackStream& to)
+    {
+        m_credit += BENCH_TXQUEUE_BAUD / 10;
+        size_t bytes = std::min<size_t>(m_credit / 1000, tx.size());
+        m_credit -= bytes * 1000;
+        if (bytes == 0)
+        {
+            m_credit = std::min<uint32_t>(m_credit, BENCH_TXQUEUE_BAUD / 10);
+            return;
+        }
+        if (to.rxIndex == to.rx.size())
+        {
+            to.rx.clear();
+            to.rxIndex = 0;
+        }
+        to.rx.insert(to.rx.end(), tx.begin(), tx.begin() + bytes);
+        tx.erase(tx.begin(), tx.begin() + bytes);
+    }
+
+    size_t overruns = 0;
+
+private:
+    uint32_t m_credit = 0;  // Byte times x1000 the wire may still carry
+};
+
+static uint32_t percentile(std::vector<uint32_t>& samples, uint32_t pct)
+{
+    if (samples.empty())
+    {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[(samples.size() - 1) * pct / 100];
+}
+
+// Body drives the dome over a 115200 baud link: bursts of 4 LED commands
+// every 20 ms and of 6 sounds every 40 ms, a move setpoint every 5 ms made
+// just after any burst, and an emergency move every 200 ms, about three
+// quarters of the link in all. With `scheduled`, each goes to the queue of
+// its class; otherwise all wait in one FIFO. Latency is from creation to
+// the dome's callback
+static void benchTxQueue(const char* name, bool scheduled)
+{
+    PacedStream bodyWire;
+    LoopbackStream domeWire;
+    C110PSerial body(&bodyWire, C110PRegion_REGION_BODY);
+    C110PSerial dome(&domeWire, C110PRegion_REGION_DOME);
+    s_txNow = 1000;
+    for (std::vector<uint32_t>& samples : s_latency)
+    {
+        samples.clear();
+    }
+    for (C110PSerial* link : {&body, &dome})
+    {
+        link->setTimestampProvider(&txNow);
+        link->setChunkedRead(true);
+        link->setDrainBudget(SIZE_MAX);
+    }
+    body.setWriteRoomCheck(true);
+    dome.setMoveCallback(&onMove);
+    dome.setLedCallback(&onLed);
+    dome.setSoundCallback(&onSound);
+
+    uint32_t nextId = 1;
+    size_t refused = 0;
+    size_t made = 0;
+    auto offer = [&](C110PCommand cmd, C110PTxClass cls) {
+        cmd.id = nextId++;
+        made++;
+        C110PSerial::SendStatus status = scheduled ? body.enqueue(cmd, cls) : body.enqueue(cmd, C110PTxClass::Move);
+        if (status != C110PSerial::SendStatus::Queued)
+        {
+            refused++;
+        }
+    };
+
+    size_t delivered = 0;
+    for (uint32_t ms = 0; ms < BENCH_TXQUEUE_MS + 1000; ++ms, ++s_txNow)
+    {
+        uint32_t now = s_txNow;
+        if (ms < BENCH_TXQUEUE_MS)
+        {
+            if (ms % 20 == 10)
+            {
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    offer(body.createLedCommand(C110PRegion_REGION_DOME, now, 0x00AA00 + i), C110PTxClass::Led);
+                }
+            }
+            if (ms % 40 == 0)
+            {
+                for (uint32_t i = 0; i < 6; ++i)
+                {
+                    offer(body.createSoundCommand(C110PRegion_REGION_DOME, now, true), C110PTxClass::Sound);
+                }
+            }
+            if (ms % 5 == 0)
+            {
+                offer(body.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK, now), C110PTxClass::Move);
+            }
+            if (ms % 200 == 10)
+            {
+                offer(body.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK, now, 1),
+                      C110PTxClass::Emergency);
+            }
+        }
+        body.processQueue();
+        bodyWire.tick(domeWire);
+        dome.processQueue();
+        // ACKs come straight back
+        if (bodyWire.rxIndex == bodyWire.rx.size())
+        {
+            bodyWire.rx.clear();
+            bodyWire.rxIndex = 0;
+        }
+        bodyWire.rx.insert(bodyWire.rx.end(), domeWire.tx.begin(), domeWire.tx.end());
+        domeWire.tx.clear();
+    }
+
+    printf("%-9s offered %zu  refused %zu  UART overruns %zu\n", name, made, refused, bodyWire.overruns);
+    const char* classes[] = {"control", "emergency", "move", "led", "sound"};
+    for (size_t cls = static_cast<size_t>(C110PTxClass::Emergency); cls <= static_cast<size_t>(C110PTxClass::Sound); ++cls)
+    {
+        std::vector<uint32_t>& samples = s_latency[cls];
+        delivered += samples.size();
+        printf("  %-9s %5zu delivered  p50 %4u ms  p90 %4u ms  p99 %4u ms\n", classes[cls], samples.size(),
+               percentile(samples, 50), percentile(samples, 90), percentile(samples, 99));
+    }
+    // Whatever was queued arrives, once, and nothing overfills the UART
+    TEST_ASSERT_EQUAL(made - refused, delivered);
+    TEST_ASSERT_EQUAL(0, bodyWire.overruns);
+    TEST_ASSERT_EQUAL(0, body.txQueued());
+}
+
+void bench_txqueue_latency(void)
+{
+    benchTxQueue("fifo", false);
+    benchTxQueue("scheduled", true);
+}
+
+int bench_txqueue_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_txqueue_latency);
+    return UNITY_END();
+}
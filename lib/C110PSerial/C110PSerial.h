@@ -4,13 +4,49 @@
 #include <Stream.h>
 
 #include "ProtoFrame.h"
+#include "TxScheduler.h"
 
+// Queues of the TX scheduler, most urgent first. Control and Emergency are
+// served in strict priority; the rest share the link by weight
+enum class C110PTxClass : uint8_t {
+    Control,      // ACK/NACK
+    Emergency,    // Types marked with setEmergency()
+    Move,
+    Led,
+    Sound
+};
+
+// Default shares of the weighted classes
+#define TX_WEIGHT_MOVE 4
+#define TX_WEIGHT_LED 2
+#define TX_WEIGHT_SOUND 1
 
-class C110PSerial : private ProtoFrame
+template<typename Config = ProtoFrameConfigDefault>
+class BasicC110PSerial : private BasicProtoFrame<Config>
 {
+    using ProtoFrame = BasicProtoFrame<Config>;
+
 public:
     // Expose selected ProtoFrame methods/attributes as public
+    using typename ProtoFrame::FrameFormat;
+    using typename ProtoFrame::Integrity;
+    using typename ProtoFrame::SendStatus;
+    using TxClass = C110PTxClass;
+    using ProtoFrame::setFrameFormat;
+    using ProtoFrame::integrity;
+    using ProtoFrame::setChunkedRead;
+    using ProtoFrame::setRxRing;
+    using ProtoFrame::setDrainBudget;
+    using ProtoFrame::setAckCoalescing;
+    using ProtoFrame::flushAcks;
+    using ProtoFrame::setPiggybackAcks;
+    using ProtoFrame::setQos;
+    using ProtoFrame::setLatestValue;
+    using ProtoFrame::setSendWindow;
+    using ProtoFrame::sendWindow;
+    using ProtoFrame::sendWindowOpen;
     using ProtoFrame::setTimestampProvider;
+    using ProtoFrame::setTickProvider;
     using ProtoFrame::setLedCallback;
     using ProtoFrame::setSoundCallback;
     using ProtoFrame::setMoveCallback;
@@ -18,27 +54,96 @@ public:
     using ProtoFrame::getReceivedMessageBufferSize;
     using ProtoFrame::getUnacknowledgedMessagesSize;
     using ProtoFrame::getUnacknowledgedMessage;
+    using ProtoFrame::sentFrames;
+    using ProtoFrame::lastReceived;
+    using ProtoFrame::receivedIds;
+    using ProtoFrame::rtt;
+    using ProtoFrame::retransmitTimeout;
+    using ProtoFrame::setRetransmitBounds;
     using ProtoFrame::getSafeTimestamp;
     using ProtoFrame::receive;
     using ProtoFrame::START_BYTE;
     using ProtoFrame::MAX_SIZE;
 
-    explicit C110PSerial(Stream* stream, C110PRegion identifier = C110PRegion_REGION_UNSPECIFIED, uint64_t timeout = 1000)
-        : ProtoFrame(stream, identifier, timeout)
+    // `integrity` picks the frame check for the link; both ends must agree
+    explicit BasicC110PSerial(Stream* stream, C110PRegion identifier = C110PRegion_REGION_UNSPECIFIED, uint64_t timeout = Config::TIMEOUT_MS,
+                              Integrity integrity = Integrity::Crc8)
+        : ProtoFrame(stream, identifier, timeout, Config::MAX_RETRIES, integrity)
     {
+        m_txQueue.setWeight(static_cast<size_t>(TxClass::Control), 0);
+        m_txQueue.setWeight(static_cast<size_t>(TxClass::Emergency), 0);
+        m_txQueue.setWeight(static_cast<size_t>(TxClass::Move), TX_WEIGHT_MOVE);
+        m_txQueue.setWeight(static_cast<size_t>(TxClass::Led), TX_WEIGHT_LED);
+        m_txQueue.setWeight(static_cast<size_t>(TxClass::Sound), TX_WEIGHT_SOUND);
     }
 
+    // Frame, track and write `msg`; see SendStatus
+    SendStatus trySend(const C110PCommand& msg);
+
+    // trySend() when only success matters
     bool send(const C110PCommand& msg);
 
-    void processQueue() {
-        ProtoFrame::readFrame();
-        retryMessages();
+    // Hold `msg` in the TX queue of its class for processQueue() to write;
+    // Queued, or WouldBlock if that queue is full. A latest-value command
+    // replaces a queued one with the same key instead of queueing behind it.
+    // With a TxQueueDepth of 0 there is no queue: `msg` is written at once,
+    // room check included, and the status is that of the write.
+    // The link's own ACKs and NACKs, from sendAck() and sendNack(), skip
+    // both the queue and the room check: they are written when due
+    SendStatus enqueue(const C110PCommand& msg);
+    SendStatus enqueue(const C110PCommand& msg, TxClass cls);
+
+    // Write queued commands, most urgent class first, for as long as the
+    // link has room and the send window allows; returns the number written
+    size_t drainTxQueue();
+
+    // Commands of type `type` (a C110PCommand_*_tag) go in the Emergency class
+    void setEmergency(pb_size_t type, bool emergency) {
+        if (type < 32)
+        {
+            m_emergencyTypes = emergency ? m_emergencyTypes | (1u << type) : m_emergencyTypes & ~(1u << type);
+        }
+    }
+
+    // Commands `cls` may send per round while other weighted classes wait;
+    // Control and Emergency are always served first
+    void setTxWeight(TxClass cls, uint8_t weight) {
+        if (cls != TxClass::Control && cls != TxClass::Emergency)
+        {
+            m_txQueue.setWeight(static_cast<size_t>(cls), weight > 0 ? weight : 1);
+        }
+    }
+
+    // Only write queued commands when availableForWrite() says they fit.
+    // Off by default: Print::availableForWrite() returns 0 on a stream that
+    // does not override it, and nothing queued would ever go out
+    void setWriteRoomCheck(bool check) {
+        m_writeRoomCheck = check;
+    }
+
+    TxClass txClass(const C110PCommand& msg) const;
+
+    size_t txQueued() const {
+        return m_txQueue.size();
+    }
+
+    size_t txQueued(TxClass cls) const {
+        return m_txQueue.size(static_cast<size_t>(cls));
+    }
+
+    // Returns the number of frames handled, at most the drain budget
+    size_t processQueue() {
+        size_t frames = ProtoFrame::drainFrames();
+        this->flushDueAcks();
+        drainTxQueue();
+        this->retryMessages();
+        return frames;
     }
 
     C110PCommand createLedCommand(C110PRegion target, uint32_t start, uint32_t end, uint32_t duration = 0) {
-        C110PCommand cmd;
+        C110PCommand cmd = C110PCommand_init_zero;
         cmd.id = this->getSafeTimestamp();
-        cmd.source = m_regionId;
+        cmd.source = this->m_regionId;
         cmd.target = target;
         cmd.which_data = C110PCommand_led_tag;
         cmd.data.led.start = start;
@@ -48,9 +153,9 @@ public:
     }
 
     C110PCommand createSoundCommand(C110PRegion target, uint32_t soundId, bool play = false, bool syncToLeds = false) {
-        C110PCommand cmd;
+        C110PCommand cmd = C110PCommand_init_zero;
         cmd.id = this->getSafeTimestamp();
-        cmd.source = m_regionId;
+        cmd.source = this->m_regionId;
         cmd.target = target;
         cmd.which_data = C110PCommand_sound_tag;
         cmd.data.sound.id = soundId;
@@ -60,9 +165,9 @@ public:
     }
 
     C110PCommand createMoveCommand(C110PRegion target, C110PActuator move_target, uint32_t x, uint32_t y = 0, uint32_t z = 0) {
-        C110PCommand cmd;
+        C110PCommand cmd = C110PCommand_init_zero;
         cmd.id = this->getSafeTimestamp();
-        cmd.source = m_regionId;
+        cmd.source = this->m_regionId;
         cmd.target = target;
         cmd.which_data = C110PCommand_move_tag;
         cmd.data.move.target = move_target;
@@ -71,4 +176,30 @@ public:
         cmd.data.move.z = z;
         return cmd;
     }
+
+private:
+    // trySend() with at most `room` bytes free on the link
+    SendStatus transmit(const C110PCommand& msg, size_t room);
+
+    // Bytes the link can take now; unbounded unless the room check is on
+    size_t writeRoom()
+    {
+        if (!m_writeRoomCheck)
+        {
+            return SIZE_MAX;
+        }
+        int available = this->m_stream->availableForWrite();
+        return available > 0 ? static_cast<size_t>(available) : 0;
+    }
+
+    TxScheduler<C110PCommand, static_cast<size_t>(TxClass::Sound) + 1, Config::TX_DEPTH> m_txQueue;
+    uint32_t m_emergencyTypes = 0;
+    bool m_writeRoomCheck = false;
 };
+
+// The default link; see ProtoFrameConfig.h for the presets
+using C110PSerial = BasicC110PSerial<>;
+
+extern template class BasicC110PSerial<ProtoFrameConfigDefault>;
+extern template class BasicC110PSerial<ProtoFrameConfigSmall>;
+extern template class BasicC110PSerial<ProtoFrameConfigLarge>;
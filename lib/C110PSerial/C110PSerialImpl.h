@@ -0,0 +1,167 @@
+#pragma once
+
+// Member definitions of BasicC110PSerial; see ProtoFrameImpl.h for how to
+// instantiate a custom config
+#include "C110PSerial.h"
+#include "ProtoFrameImpl.h"
+
+template<typename Config>
+bool BasicC110PSerial<Config>::send(const C110PCommand& msg)
+{
+    return trySend(msg) == SendStatus::Sent;
+}
+
+template<typename Config>
+typename BasicC110PSerial<Config>::SendStatus BasicC110PSerial<Config>::trySend(const C110PCommand& msg)
+{
+    return transmit(msg, SIZE_MAX);
+}
+
+template<typename Config>
+typename BasicC110PSerial<Config>::SendStatus BasicC110PSerial<Config>::transmit(const C110PCommand& msg, size_t room)
+{
+    if (ProtoFrame::isControl(msg))
+    {
+        // Nothing waits for an ACK of an ACK, so it is neither kept nor
+        // tracked, and the window does not hold it back
+        typename ProtoFrame::SentFrame frame = this->encodeFrame(msg, room);
+        if (!frame.data)
+        {
+            return frame.length > 0 ? SendStatus::WouldBlock : SendStatus::EncodeFailed;
+        }
+        return this->writeFrame(frame) ? SendStatus::Sent : SendStatus::WriteFailed;
+    }
+    // Best-effort commands go out once, window or not; a command that
+    // supersedes one in flight takes its place in the window
+    C110PQos qos = this->qosFor(msg);
+    bool reliable = qos == C110PQos_QOS_RELIABLE;
+    if (reliable && !this->sendWindowOpen() && !this->supersedes(msg))
+    {
+        C110P_TRACE_EVENT(TraceEvent::SendBlocked, msg.id, this->getSafeTimestamp());
+        return SendStatus::WouldBlock;
+    }
+
+    // A held ACK rides along when piggybacking, in place of its own frame
+    uint32_t piggyback = this->piggybackAck();
+    C110PCommand carrier;
+    const C110PCommand* framed = &msg;
+    if (piggyback != 0 || qos != msg.qos)
+    {
+        carrier = msg;
+        carrier.qos = qos;
+        if (piggyback != 0)
+        {
+            carrier.piggyback_ack = piggyback;
+        }
+        framed = &carrier;
+    }
+    // A reliable command is framed once into the sent frame arena; retries
+    // write those bytes again
+    typename ProtoFrame::SentFrame frame = this->encodeFrame(*framed, room);
+    if (!frame.data)
+    {
+        if (frame.length > 0)
+        {
+            C110P_TRACE_EVENT(TraceEvent::SendBlocked, msg.id, this->getSafeTimestamp());
+            return SendStatus::WouldBlock;
+        }
+        return SendStatus::EncodeFailed;
+    }
+    // Only a command that is framed takes the ACK or the older command's place
+    if (piggyback != 0)
+    {
+        this->consumePiggybackAck();
+    }
+    this->supersede(msg);
+    if (reliable)
+    {
+        this->trackMessage(msg.id, this->getSafeTimestamp(), 0, msg.target);
+    }
+    C110P_TRACE_EVENT(TraceEvent::Sent, msg.id, this->getSafeTimestamp());
+    return this->writeFrame(frame) ? SendStatus::Sent : SendStatus::WriteFailed;
+}
+
+template<typename Config>
+C110PTxClass BasicC110PSerial<Config>::txClass(const C110PCommand& msg) const
+{
+    if (ProtoFrame::isControl(msg))
+    {
+        return TxClass::Control;
+    }
+    if (msg.which_data < 32 && ((m_emergencyTypes >> msg.which_data) & 1u))
+    {
+        return TxClass::Emergency;
+    }
+    switch (msg.which_data)
+    {
+        case C110PCommand_move_tag:
+            return TxClass::Move;
+        case C110PCommand_led_tag:
+            return TxClass::Led;
+        default:
+            return TxClass::Sound;
+    }
+}
+
+template<typename Config>
+typename BasicC110PSerial<Config>::SendStatus BasicC110PSerial<Config>::enqueue(const C110PCommand& msg)
+{
+    return enqueue(msg, txClass(msg));
+}
+
+template<typename Config>
+typename BasicC110PSerial<Config>::SendStatus BasicC110PSerial<Config>::enqueue(const C110PCommand& msg, TxClass cls)
+{
+    if constexpr (Config::TX_DEPTH == 0)
+    {
+        (void)cls;
+        return transmit(msg, writeRoom());
+    }
+    size_t queue = static_cast<size_t>(cls);
+    // A newer value of the same key takes the older one's place in line,
+    // so a burst of setpoints goes out as its latest
+    uint32_t key = this->latestValueKey(msg);
+    if (key != 0)
+    {
+        C110PCommand* queued = m_txQueue.find(queue, [this, key](const C110PCommand& item) {
+            return this->latestValueKey(item) == key;
+        });
+        if (queued)
+        {
+            C110P_TRACE_EVENT(TraceEvent::Superseded, queued->id, this->getSafeTimestamp());
+            *queued = msg;
+            return SendStatus::Queued;
+        }
+    }
+    if (!m_txQueue.push(queue, msg))
+    {
+        C110P_TRACE_EVENT(TraceEvent::SendBlocked, msg.id, this->getSafeTimestamp());
+        return SendStatus::WouldBlock;
+    }
+    return SendStatus::Queued;
+}
+
+template<typename Config>
+size_t BasicC110PSerial<Config>::drainTxQueue()
+{
+    size_t written = 0;
+    if constexpr (Config::TX_DEPTH > 0)
+    {
+        for (size_t cls = m_txQueue.select(); cls != m_txQueue.NONE; cls = m_txQueue.select())
+        {
+            // The head of the chosen class waits for room or the window
+            // rather than letting a lesser class past it
+            SendStatus status = transmit(m_txQueue.front(cls), writeRoom());
+            if (status == SendStatus::WouldBlock)
+            {
+                break;
+            }
+            m_txQueue.pop(cls);
+            if (status == SendStatus::Sent)
+            {
+                written++;
+            }
+        }
+    }
+    return written;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Consistent Overhead Byte Stuffing: removes every 0x00 from a block so 0x00
+// can delimit frames on the wire. Overhead is at most 1 byte per 254.
+class COBS {
+public:
+    static const uint8_t DELIMITER = 0x00;
+
+    // Worst case encoded size of `len` bytes, not counting the delimiter
+    static constexpr size_t maxEncodedSize(size_t len)
+    {
+        return len + (len / 254) + 1;
+    }
+
+    // Encode `len` bytes from `src` into `dst`, which must hold
+    // maxEncodedSize(len) bytes. Returns the number of bytes written.
+    static size_t encode(const uint8_t* src, size_t len, uint8_t* dst)
+    {
+        size_t codeIndex = 0;
+        size_t out = 1;
+        uint8_t code = 1;
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (src[i] == DELIMITER)
+            {
+                dst[codeIndex] = code;
+                codeIndex = out++;
+                code = 1;
+                continue;
+            }
+            dst[out++] = src[i];
+            if (++code == 0xFF)
+            {
+                // A full block carries no implied zero; only open another if
+                // there is more input
+                dst[codeIndex] = code;
+                if (i + 1 == len)
+                {
+                    return out;
+                }
+                codeIndex = out++;
+                code = 1;
+            }
+        }
+        dst[codeIndex] = code;
+        return out;
+    }
+
+    // Decode `len` bytes from `src` into `dst`; `dst` may be the same buffer
+    // as `src`. Returns the decoded length, or 0 if the block is malformed.
+    static size_t decode(const uint8_t* src, size_t len, uint8_t* dst)
+    {
+        size_t in = 0;
+        size_t out = 0;
+        while (in < len)
+        {
+            uint8_t code = src[in++];
+            if (code == DELIMITER || in + code - 1 > len)
+            {
+                return 0;
+            }
+            for (uint8_t i = 1; i < code; ++i)
+            {
+                if (src[in] == DELIMITER)
+                {
+                    return 0;
+                }
+                dst[out++] = src[in++];
+            }
+            if (code != 0xFF && in < len)
+            {
+                dst[out++] = DELIMITER;
+            }
+        }
+        return out;
+    }
+};
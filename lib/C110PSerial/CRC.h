@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Table driven CRC of `Width` bits (8, 16 or 32) described by the usual
+// Rocksoft parameters. Tables are built at compile time and live in rodata;
+// slicing-by-N tables are only emitted for the N actually used.
+//
+// Streaming use: crc = begin(); crc = update(crc, chunk, len)...; finish(crc)
+template<typename T, unsigned Width, T Poly, T Init, T XorOut, bool Reflect>
+class CrcEngine {
+    static_assert(Width == 8 || Width == 16 || Width == 32, "Width must be 8, 16 or 32");
+    static_assert(sizeof(T) * 8 >= Width, "T is too narrow for Width");
+
+public:
+    using value_type = T;
+
+    static constexpr unsigned WIDTH = Width;
+    static constexpr size_t BYTES = Width / 8;
+    static constexpr T POLY = Poly;
+    static constexpr T INIT = Init;
+    static constexpr T XOROUT = XorOut;
+    static constexpr bool REFLECT = Reflect;
+
+    template<size_t N>
+    struct Tables {
+        T v[N][256];
+    };
+
+    static constexpr T begin()
+    {
+        return Reflect ? reflect(Init) : Init;
+    }
+
+    static constexpr T update(T crc, const uint8_t* data, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            crc = step(crc, data[i]);
+        }
+        return crc;
+    }
+
+    // Fold in one byte
+    static constexpr T step(T crc, uint8_t byte)
+    {
+        if (Reflect)
+        {
+            return static_cast<T>((Width > 8 ? crc >> 8 : 0) ^ s_table.v[0][static_cast<uint8_t>(crc ^ byte)]);
+        }
+        return static_cast<T>(((crc << 8) & MASK) ^ s_table.v[0][static_cast<uint8_t>((crc >> (Width - 8)) ^ byte)]);
+    }
+
+    // Same result as update(), N bytes per step using N lookup tables
+    template<size_t N>
+    static T updateSliced(T crc, const uint8_t* data, size_t len)
+    {
+        static_assert(N * 8 >= Width && N <= 8, "N must cover the CRC width and be at most 8");
+        for (; len >= N; len -= N, data += N)
+        {
+            crc = sliceStep(crc, data, std::make_index_sequence<N>());
+        }
+        return update(crc, data, len);
+    }
+
+    static constexpr T finish(T crc)
+    {
+        return static_cast<T>((crc ^ XorOut) & MASK);
+    }
+
+    static constexpr T calculate(const uint8_t* data, size_t len)
+    {
+        return finish(update(begin(), data, len));
+    }
+
+    template<size_t N>
+    static T calculateSliced(const uint8_t* data, size_t len)
+    {
+        return finish(updateSliced<N>(begin(), data, len));
+    }
+
+    // CRC of a single byte from a zero register, i.e. the lookup table entry
+    static constexpr T table(uint8_t byte)
+    {
+        return s_table.v[0][byte];
+    }
+
+private:
+    static constexpr T MASK = static_cast<T>(Width == sizeof(T) * 8 ? ~T(0) : (T(1) << Width) - 1);
+    static constexpr T TOP_BIT = static_cast<T>(T(1) << (Width - 1));
+
+    static constexpr T reflect(T value)
+    {
+        T out = 0;
+        for (unsigned i = 0; i < Width; ++i)
+        {
+            if (value & (T(1) << i))
+            {
+                out |= static_cast<T>(T(1) << (Width - 1 - i));
+            }
+        }
+        return out;
+    }
+
+    static constexpr T bytewise(uint8_t byte)
+    {
+        if (Reflect)
+        {
+            T crc = byte;
+            T poly = reflect(Poly);
+            for (int i = 0; i < 8; ++i)
+            {
+                crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ poly) : static_cast<T>(crc >> 1);
+            }
+            return crc;
+        }
+        T crc = static_cast<T>(T(byte) << (Width - 8));
+        for (int i = 0; i < 8; ++i)
+        {
+            crc = (crc & TOP_BIT) ? static_cast<T>(((crc << 1) ^ Poly) & MASK) : static_cast<T>((crc << 1) & MASK);
+        }
+        return crc;
+    }
+
+    // One slicing step, unrolled at compile time. The register is absorbed
+    // by the first Width / 8 bytes; table N - 1 - j advances byte j to the
+    // end of the block
+    template<size_t... J>
+    static T sliceStep(T crc, const uint8_t* data, std::index_sequence<J...>)
+    {
+        constexpr size_t N = sizeof...(J);
+        const Tables<N>& tables = s_slices<N>;
+        return static_cast<T>((tables.v[N - 1 - J][static_cast<uint8_t>(data[J] ^ registerByte(crc, J))] ^ ...));
+    }
+
+    static constexpr uint8_t registerByte(T crc, size_t j)
+    {
+        if (j >= BYTES)
+        {
+            return 0;
+        }
+        return static_cast<uint8_t>(Reflect ? crc >> (8 * j) : crc >> (Width - 8 - 8 * j));
+    }
+
+    // Table k holds the CRC of a byte followed by k zero bytes
+    template<size_t N>
+    static constexpr Tables<N> build()
+    {
+        Tables<N> t = {};
+        for (int i = 0; i < 256; ++i)
+        {
+            t.v[0][i] = bytewise(static_cast<uint8_t>(i));
+        }
+        for (size_t k = 1; k < N; ++k)
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                T prev = t.v[k - 1][i];
+                t.v[k][i] = Reflect
+                    ? static_cast<T>((Width > 8 ? prev >> 8 : 0) ^ t.v[0][static_cast<uint8_t>(prev)])
+                    : static_cast<T>(((prev << 8) & MASK) ^ t.v[0][static_cast<uint8_t>(prev >> (Width - 8))]);
+            }
+        }
+        return t;
+    }
+
+    static constexpr Tables<1> s_table = build<1>();
+
+    template<size_t N>
+    static constexpr Tables<N> s_slices = build<N>();
+};
+
+// Catalogue names; check value is the CRC of "123456789"
+using Crc8 = CrcEngine<uint8_t, 8, 0x07, 0x00, 0x00, false>;                           // 0xF4
+using Crc16Ccitt = CrcEngine<uint16_t, 16, 0x1021, 0xFFFF, 0x0000, false>;             // 0x29B1
+using Crc32 = CrcEngine<uint32_t, 32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true>;       // 0xCBF43926
+using Crc32C = CrcEngine<uint32_t, 32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true>;      // 0xE3069283
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Ids are millisecond timestamps, so this spans 8160 ms of the sender's
+// clock: the default 1 s timeout doubled over 3 retries, jitter included
+#define DEDUP_WINDOW_BITS 8192
+// Peers a link keeps a window for; a UART link has one sender, plus room
+// for messages that leave their source unset
+#define DEDUP_WINDOW_PEERS 2
+
+// Smallest window, in bits, whose span covers `span` ms of retries
+constexpr size_t dedupWindowBits(size_t span, size_t bits = 64)
+{
+    return bits - 32 >= span ? bits : dedupWindowBits(span, bits * 2);
+}
+
+// Anti-replay style record of the message ids already seen from one peer:
+// the highest id so far plus a bitmap of the ids just below it, so checking
+// an id is O(1) however many messages the window spans.
+//
+// Ids are compared in serial number arithmetic, so the 32 bit timestamp ids
+// may wrap. The bitmap is a ring of 32 bit words indexed by the id itself;
+// moving the highest id forward clears the words it passes over. The word
+// holding the highest id is shared with ids a whole bitmap below it, so the
+// window covers the last WINDOW = Bits - 32 ids. An id further below the
+// highest than that cannot be a retransmit of a message the peer is still
+// retrying, so the peer has restarted its clock and the window starts over.
+template<size_t Bits = DEDUP_WINDOW_BITS>
+class DedupWindow
+{
+    static_assert(Bits >= 64 && (Bits & (Bits - 1)) == 0, "Bits must be a power of two, at least 64");
+
+public:
+    enum class Result : uint8_t {
+        Fresh,      // Not seen before, now recorded
+        Duplicate   // Seen before
+    };
+
+    static constexpr uint32_t WINDOW = Bits - 32;
+
+    // Classify `id` and record it if it is fresh
+    Result check(uint32_t id)
+    {
+        if (!m_started)
+        {
+            restart(id);
+            return Result::Fresh;
+        }
+
+        uint32_t ahead = id - m_highest;
+        if (ahead != 0 && ahead < 0x80000000u)
+        {
+            advance(id);
+            return Result::Fresh;
+        }
+
+        if (m_highest - id >= WINDOW)
+        {
+            restart(id);
+            return Result::Fresh;
+        }
+
+        uint32_t& word = m_words[wordIndex(id)];
+        uint32_t bit = 1u << (id & 31);
+        if (word & bit)
+        {
+            return Result::Duplicate;
+        }
+        word |= bit;
+        return Result::Fresh;
+    }
+
+    // Whether `id` has been recorded and is still inside the window
+    bool contains(uint32_t id) const
+    {
+        if (!m_started || m_highest - id >= WINDOW)
+        {
+            return false;
+        }
+        return (m_words[wordIndex(id)] >> (id & 31)) & 1u;
+    }
+
+    uint32_t highest() const
+    {
+        return m_highest;
+    }
+
+    bool empty() const
+    {
+        return !m_started;
+    }
+
+    void reset()
+    {
+        memset(m_words, 0, sizeof(m_words));
+        m_highest = 0;
+        m_started = false;
+    }
+
+private:
+    static constexpr size_t WORDS = Bits / 32;
+
+    static size_t wordIndex(uint32_t id)
+    {
+        return (id >> 5) & (WORDS - 1);
+    }
+
+    void restart(uint32_t id)
+    {
+        memset(m_words, 0, sizeof(m_words));
+        m_started = true;
+        m_highest = id;
+        m_words[wordIndex(id)] = 1u << (id & 31);
+    }
+
+    // Clear the words between the old and new highest id, then record it
+    void advance(uint32_t id)
+    {
+        // Word numbers are 27 bits wide; mask so the difference survives a wrap
+        uint32_t words = ((id >> 5) - (m_highest >> 5)) & 0x07FFFFFFu;
+        if (words >= WORDS)
+        {
+            memset(m_words, 0, sizeof(m_words));
+        }
+        else
+        {
+            for (uint32_t i = 1; i <= words; ++i)
+            {
+                m_words[wordIndex(m_highest + (i << 5))] = 0;
+            }
+        }
+        m_highest = id;
+        m_words[wordIndex(id)] |= 1u << (id & 31);
+    }
+
+    uint32_t m_words[WORDS] = {};
+    uint32_t m_highest = 0;
+    bool m_started = false;
+};
+
+// Duplicate windows for the peers that send to this node, so a link pays
+// for the sources it hears rather than for every region. A source takes a
+// free window on its first message; with none free it takes over the one
+// heard from least recently, whose next message then starts a new window.
+template<size_t Bits, size_t Peers>
+class DedupPeers
+{
+    static_assert(Peers > 0, "Peers must be at least 1");
+
+public:
+    using Window = DedupWindow<Bits>;
+
+    // The window of `source`, assigned if it has none
+    Window& operator[](uint8_t source)
+    {
+        size_t slot = 0;
+        for (size_t i = 0; i < Peers; ++i)
+        {
+            if (m_peers[i].heard != 0 && m_peers[i].source == source)
+            {
+                slot = i;
+                break;
+            }
+            if (m_peers[i].heard < m_peers[slot].heard)
+            {
+                slot = i;
+            }
+        }
+
+        Peer& peer = m_peers[slot];
+        if (peer.heard == 0 || peer.source != source)
+        {
+            peer.ids.reset();
+            peer.source = source;
+        }
+        if (++m_heard == 0)
+        {
+            m_heard = 1;
+        }
+        peer.heard = m_heard;
+        return peer.ids;
+    }
+
+    void reset()
+    {
+        for (Peer& peer : m_peers)
+        {
+            peer.ids.reset();
+            peer.heard = 0;
+        }
+        m_heard = 0;
+    }
+
+private:
+    struct Peer {
+        Window ids;
+        uint32_t heard = 0;  // Order of the last lookup; 0 while free
+        uint8_t source = 0;
+    };
+
+    Peer m_peers[Peers];
+    uint32_t m_heard = 0;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "RingBuffer.h"
+
+// Arena bytes set aside per held frame. LED, sound and move frames take
+// 18-27 bytes, so the full depth of them fits; longer frames are held for
+// fewer messages
+#define SENT_FRAME_BUDGET 28
+
+// The framed bytes of sent messages, exactly as written to the stream, so a
+// retransmit is a single write() with no encoding or CRC work.
+//
+// Frames are laid out one after another in a fixed byte arena that wraps
+// around, and found by id through a RingBuffer of (id, offset, length)
+// records. A frame is built in place: reserve() hands out room for it,
+// evicting the oldest frames in the way, and commit() stores the part
+// actually used. At most Depth frames are held, fewer when they are long.
+template<size_t ArenaSize, size_t Depth>
+class FrameCache
+{
+    static_assert(ArenaSize > 0 && ArenaSize <= UINT16_MAX, "ArenaSize must fit a 16 bit offset");
+
+public:
+    struct Frame {
+        const uint8_t* data;
+        size_t length;
+    };
+
+    // Room for a frame of up to `maxLength` bytes, contiguous in the arena.
+    // Valid until the next reserve(); nothing is stored until commit()
+    uint8_t* reserve(size_t maxLength)
+    {
+        if (m_head + maxLength > ArenaSize)
+        {
+            // Frames past the head are the oldest; the gap to the end is
+            // skipped, so they go before anything at the start is reused
+            while (!m_entries.empty() && m_entries.oldest().offset >= m_head)
+            {
+                m_entries.dropOldest();
+            }
+            m_head = 0;
+        }
+        while (!m_entries.empty() && m_entries.oldest().offset >= m_head &&
+               m_entries.oldest().offset < m_head + maxLength)
+        {
+            m_entries.dropOldest();
+        }
+        return &m_arena[m_head];
+    }
+
+    // Whether reserve(maxLength) and its commit() would evict a frame whose
+    // id `held` returns true for; nothing is changed
+    template<typename F>
+    bool evicts(size_t maxLength, F&& held) const
+    {
+        auto it = m_entries.begin();
+        size_t dropped = 0;
+        size_t head = m_head;
+        if (head + maxLength > ArenaSize)
+        {
+            for (; it != m_entries.end() && it->offset >= head; ++it, ++dropped)
+            {
+                if (held(it->id))
+                {
+                    return true;
+                }
+            }
+            head = 0;
+        }
+        for (; it != m_entries.end() && it->offset >= head && it->offset < head + maxLength; ++it, ++dropped)
+        {
+            if (held(it->id))
+            {
+                return true;
+            }
+        }
+        // A full index also drops its oldest record to take the new one
+        return it != m_entries.end() && m_entries.size() - dropped >= Depth && held(it->id);
+    }
+
+    // Store the first `length` bytes of the reserved room as the frame of
+    // `id`, replacing any frame already held for it
+    void commit(uint32_t id, size_t length)
+    {
+        m_entries.forget(id);
+        Entry& entry = m_entries.prepare();
+        entry.id = id;
+        entry.offset = static_cast<uint16_t>(m_head);
+        entry.length = static_cast<uint16_t>(length);
+        m_entries.commit();
+        m_head += length;
+    }
+
+    // Frame held for `id`, or {nullptr, 0}
+    Frame get(uint32_t id) const
+    {
+        const Entry* entry = m_entries.get(id);
+        if (!entry)
+        {
+            return {nullptr, 0};
+        }
+        return {&m_arena[entry->offset], entry->length};
+    }
+
+    bool contains(uint32_t id) const
+    {
+        return m_entries.contains(id);
+    }
+
+    uint32_t size() const
+    {
+        return m_entries.size();
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Depth;
+    }
+
+    static constexpr size_t arenaSize()
+    {
+        return ArenaSize;
+    }
+
+    void reset()
+    {
+        m_entries.reset();
+        m_head = 0;
+    }
+
+private:
+    struct Entry {
+        uint32_t id;
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    uint8_t m_arena[ArenaSize];
+    size_t m_head = 0;  // Where the next frame goes
+    RingBuffer<Entry, Depth> m_entries;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Fixed-size open addressing map from a message id to a slot number in
+// 0..Capacity, for containers that store their messages in an array and
+// must find them by id without allocating.
+//
+// The table has at least twice as many entries as ids held, so linear
+// probe runs stay short; erase() shifts the rest of the run back, so there
+// are no tombstones and lookups never slow down with churn.
+template<size_t Capacity>
+class IdIndex
+{
+public:
+    using Slot = typename std::conditional<(Capacity < UINT16_MAX), uint16_t, uint32_t>::type;
+    static constexpr Slot NONE = static_cast<Slot>(~Slot(0));
+
+    IdIndex()
+    {
+        clear();
+    }
+
+    // Slot stored for `id`, or NONE
+    Slot find(uint32_t id) const
+    {
+        return m_entries[probe(id)].slot;
+    }
+
+    // Store `slot` for `id`, replacing any slot already stored for it
+    void insert(uint32_t id, Slot slot)
+    {
+        size_t i = probe(id);
+        m_entries[i].id = id;
+        m_entries[i].slot = slot;
+    }
+
+    // Forget `id`; returns false if it was not stored
+    bool erase(uint32_t id)
+    {
+        return eraseAt(probe(id));
+    }
+
+    // Forget `id` only while it still maps to `slot`, for an id that may
+    // since have been stored again elsewhere
+    bool erase(uint32_t id, Slot slot)
+    {
+        size_t i = probe(id);
+        return m_entries[i].slot == slot && eraseAt(i);
+    }
+
+    void clear()
+    {
+        for (Entry& entry : m_entries)
+        {
+            entry.slot = NONE;
+        }
+    }
+
+private:
+    static constexpr size_t tableSize(size_t n)
+    {
+        size_t size = 1;
+        while (size < 2 * n)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+    static constexpr size_t tableBits(size_t size)
+    {
+        return size > 1 ? 1 + tableBits(size >> 1) : 0;
+    }
+    static constexpr size_t SIZE = tableSize(Capacity);
+    static constexpr size_t BITS = tableBits(SIZE);
+    static constexpr size_t MASK = SIZE - 1;
+    static_assert(BITS < 32, "IdIndex capacity is too large");
+
+    struct Entry {
+        uint32_t id;
+        Slot slot;
+    };
+
+    static size_t home(uint32_t id)
+    {
+        // Fibonacci hashing: the top bits of the product spread sequential
+        // ids and timestamps evenly
+        return static_cast<size_t>(static_cast<uint32_t>(id * 2654435769u) >> (32 - BITS));
+    }
+
+    // Entry holding `id`, or the empty entry that ends its probe run
+    size_t probe(uint32_t id) const
+    {
+        size_t i = home(id);
+        while (m_entries[i].slot != NONE && m_entries[i].id != id)
+        {
+            i = (i + 1) & MASK;
+        }
+        return i;
+    }
+
+    // Backward shift deletion: later entries of the run move up into the
+    // hole unless that would put them before their home
+    bool eraseAt(size_t hole)
+    {
+        if (m_entries[hole].slot == NONE)
+        {
+            return false;
+        }
+        for (size_t j = (hole + 1) & MASK; m_entries[j].slot != NONE; j = (j + 1) & MASK)
+        {
+            size_t k = home(m_entries[j].id);
+            if (((j - k) & MASK) >= ((j - hole) & MASK))
+            {
+                m_entries[hole] = m_entries[j];
+                hole = j;
+            }
+        }
+        m_entries[hole].slot = NONE;
+        return true;
+    }
+
+    Entry m_entries[SIZE];
+};
@@ -4,76 +4,451 @@
 #include <Stream.h>
 
 #include <iostream>
-#include <chrono>
+#include <functional>
 #include <stdio.h>
+#include <cstdint>
 #include <pb_encode.h>
 #include <pb_decode.h>
 #include "c110p_serial.pb.h" // Generated by nanopb
 
 #include "RingBuffer.h"
 #include "CRC8.h"
+#include "COBS.h"
+#include "DedupWindow.h"
+#include "FrameCache.h"
+#include "RetryWheel.h"
+#include "RttEstimator.h"
+#include "SpscByteRing.h"
+#include "Varint.h"
+#include "Trace.h"
+#include "ProtoFrameConfig.h"
 
-#define BUFFER_DATA_MAX_SIZE 128
-#define BUFFER_MESSAGE_MAX_SIZE 256
+// Wire format of a frame:
+//   StartLength: | START_BYTE | len | data | crc |
+//   Cobs:        | COBS(data | crc) | 0x00 |
+//   Varint:      | START_BYTE | varint(len) | data | crc |
+enum class ProtoFrameFormat : uint8_t {
+    StartLength,
+    Cobs,
+    Varint
+};
+
+// Frame check carried as `crc` above, least significant byte first. Both
+// ends of a link must use the same mode; the wider checks let far fewer
+// corrupted frames through to pb_decode on a noisy link
+enum class ProtoFrameIntegrity : uint8_t {
+    Crc8,   // 1 byte, Config::CrcPolicy (CRC-8/0x07 by default)
+    Crc16,  // 2 bytes, CRC-16/CCITT-FALSE
+    Crc32C  // 4 bytes, CRC-32C (Castagnoli)
+};
+
+// Keys (target region, command type, actuator) whose latest command is
+// remembered for setLatestValue()
+#define LATEST_VALUE_KEYS 8
+
+// Outcome of BasicC110PSerial::trySend()
+enum class ProtoFrameSendStatus : uint8_t {
+    Sent,
+    WouldBlock,    // Send window full, no arena room without evicting a frame in flight, or
+                   // no room to write: nothing written, try again later
+    Queued,        // Held in the TX queue; processQueue() writes it when its turn comes
+    EncodeFailed,
+    WriteFailed    // Tracked all the same, so it is retried
+};
 
-class ProtoFrame
+template<typename Config = ProtoFrameConfigDefault>
+class BasicProtoFrame
 {
 public:
+    using ConfigType = Config;
+    using Clock = typename Config::ClockPolicy;
+    using Crc = typename Config::CrcPolicy;
+
+    static constexpr size_t MAX_SIZE = Config::MAX_FRAME_SIZE;
+    // Widest frame check, see ProtoFrameIntegrity
+    static constexpr size_t CRC_MAX_BYTES = 4;
+    // Largest [data...][crc]: a MAX_SIZE - 1 byte payload and the widest check
+    static constexpr size_t FRAME_BODY_MAX_SIZE = MAX_SIZE - 1 + CRC_MAX_BYTES;
+    // Largest COBS block on the wire: payload + crc + stuffing overhead
+    static constexpr size_t COBS_MAX_SIZE = COBS::maxEncodedSize(FRAME_BODY_MAX_SIZE);
+    // Holds the payload of a StartLength frame or a whole COBS block
+    static constexpr size_t INPUT_BUFFER_SIZE = COBS_MAX_SIZE;
+    static constexpr size_t RX_STAGE_SIZE = Config::RX_STAGE_SIZE;
+    // Longest length field of a valid frame
+    static constexpr size_t LENGTH_MAX_BYTES = Varint::encodedSize(MAX_SIZE - 1);
+    // Room in front of the stage to push back [len...][data...][crc]
+    static constexpr size_t RX_STAGE_HEADROOM = LENGTH_MAX_BYTES + FRAME_BODY_MAX_SIZE;
+    // Longest frame on the wire in any format, delimiter or header included
+    static constexpr size_t FRAME_MAX_WIRE_SIZE = COBS_MAX_SIZE + 1 > 1 + RX_STAGE_HEADROOM
+                                                  ? COBS_MAX_SIZE + 1 : 1 + RX_STAGE_HEADROOM;
+    // Arena for the sent frames: the per frame budget for each, but never
+    // less than one frame of the largest size
+    static constexpr size_t SENT_ARENA_SIZE = Config::RING_DEPTH * SENT_FRAME_BUDGET > FRAME_MAX_WIRE_SIZE
+                                              ? Config::RING_DEPTH * SENT_FRAME_BUDGET : FRAME_MAX_WIRE_SIZE;
+
     C110PRegion m_regionId;
     Stream* m_stream;
-    RingBuffer<C110PCommand> m_sentMessageBuffer;     // Ring buffer for storing SENT messages
-    RingBuffer<C110PCommand> m_receivedMessageBuffer; // Ring buffer for storing RECEIVED messages
+    // Sent messages are kept as the frames written, ready to retransmit
+    using SentFrames = FrameCache<SENT_ARENA_SIZE, Config::RING_DEPTH>;
+    using SentFrame = typename SentFrames::Frame;
+    SentFrames m_sentFrames;
+    // ACKs, NACKs and best-effort commands are never retried, so they are
+    // framed here rather than in the arena, where they would evict frames
+    // that might be
+    uint8_t m_scratchFrame[FRAME_MAX_WIRE_SIZE];
+    C110PCommand m_lastSent = {};
+    // Received messages are not kept: duplicates are recognised by id, per
+    // sending region, and only the latest message is held
+    using ReceivedIds = DedupWindow<Config::DEDUP_BITS>;
+    DedupPeers<Config::DEDUP_BITS, Config::DEDUP_PEERS> m_receivedIds;
+    C110PCommand m_receivedSlots[2] = {}; // Latest accepted message, and the slot the next one is decoded into
+    uint8_t m_lastReceivedSlot = 0;
+    uint32_t m_receivedCount = 0;         // Messages accepted since the last reset()
     uint32_t m_messageTimeout;               // Timeout for message acknowledgment
     uint32_t m_maxRetries;               // Maximum number of retries for unacknowledged messages
     struct MessageInfo {
         uint32_t lastProcessedTimestamp;
         uint8_t retryCount;
+        uint8_t peer;                    // C110PRegion the message went to
     };
 
-    std::unordered_map<uint32_t, MessageInfo> m_messageInfoMap; // message_id -> info
+    // Round trip estimate per peer, by region. Until a peer has been
+    // measured its retransmit timeout is m_messageTimeout
+    RttEstimator m_rtt[_C110PRegion_ARRAYSIZE];
+    uint32_t m_minRto = RTO_MIN_MS;
+    uint32_t m_maxRto = RTO_MAX_MS;
+    uint32_t m_jitterState;              // xorshift32 state for retry jitter
+
+    // Messages waiting for an ACK, by the deadline of their next retry. A
+    // message can only be retried while its frame is held, so the sent
+    // history depth bounds how many are tracked
+    using PendingMessages = RetryWheel<MessageInfo, Config::RING_DEPTH>;
+    PendingMessages m_pendingMessages;
 
     static constexpr int8_t START_BYTE = 0xAA;
-    static constexpr size_t MAX_SIZE = 128;
     
-    uint8_t m_inputBuffer[BUFFER_MESSAGE_MAX_SIZE];
+    uint8_t m_inputBuffer[INPUT_BUFFER_SIZE];
     size_t m_inputIndex = 0;
     size_t m_inputLength = 0;
-    uint8_t m_inputCrc = 0;
+    uint8_t m_inputCrc[CRC_MAX_BYTES];      // Check bytes as received
+    uint32_t m_inputCrcState = 0;           // Payload bytes folded in as they are stored
+    uint8_t m_inputLengthRaw[LENGTH_MAX_BYTES]; // Length field as received, for resync
+    size_t m_inputLengthBytes = 0;
+
+    // Staging buffer for chunked reads: bytes pulled from the stream with
+    // readBytes() that have not been fed through the frame parser yet.
+    // Reads land after RX_STAGE_HEADROOM bytes of headroom so a failed
+    // frame candidate can be pushed back in front of them and rescanned.
+    uint8_t m_rxStage[RX_STAGE_HEADROOM + RX_STAGE_SIZE];
+    size_t m_rxStageHead = RX_STAGE_HEADROOM;
+    size_t m_rxStageTail = RX_STAGE_HEADROOM;
+    bool m_chunkedRead = false;
+    size_t m_rxBytesRead = 0;  // Total bytes pulled from the stream
+    SpscByteRingBase* m_rxRing = nullptr; // Receive source in place of the stream, see setRxRing()
+
+    // Per drainFrames() call limits; the defaults handle one frame per call
+    size_t m_drainMaxFrames = 1;
+    size_t m_drainMaxBytes = SIZE_MAX;
+
+    // ACKs held back to go out together, see setAckCoalescing(). A batch
+    // carries the first id plus an offset for each of the others
+    static constexpr size_t ACK_BATCH_MAX = 1 + sizeof(AckBatchCommand::offsets) / sizeof(AckBatchCommand::offsets[0]);
+    uint32_t m_pendingAcks[ACK_BATCH_MAX];
+    size_t m_pendingAckCount = 0;
+    uint32_t m_pendingAckSince = 0;    // When the oldest pending ACK was queued
+    uint32_t m_ackDelay = 0;
+    size_t m_ackBatch = 1;             // 1: every ACK goes out on its own at once
+    size_t m_sendWindow = Config::RING_DEPTH; // Commands in flight at most, see setSendWindow()
+    bool m_piggybackAcks = false;      // Held ACKs ride on outgoing commands, see setPiggybackAcks()
+    uint32_t m_bestEffortTypes = 0;    // Bit per which_data tag sent best-effort, see setQos()
+    uint32_t m_latestValueTypes = 0;   // Bit per which_data tag where only the latest counts, see setLatestValue()
+    struct LatestValue {
+        uint32_t key;
+        uint32_t id;
+    };
+    LatestValue m_latestValues[LATEST_VALUE_KEYS];
+    size_t m_latestValueCount = 0;
+    size_t m_latestValueNext = 0;      // Entry replaced next once all are in use
+
+    enum class FrameStatus : uint8_t {
+        Incomplete,
+        Complete,
+        Invalid
+    };
+
+    using FrameFormat = ProtoFrameFormat;
+    using Integrity = ProtoFrameIntegrity;
+    using SendStatus = ProtoFrameSendStatus;
+
+    FrameFormat m_frameFormat = FrameFormat::StartLength;
+    Integrity m_integrity;
+    size_t m_crcBytes;
+    bool m_inputOverflow = false;
 
     std::function<uint64_t()> m_timestampProvider = nullptr; // Timestamp provider function
+    uint32_t (*m_tickProvider)() = nullptr; // Cheap monotonic millisecond tick for the read loop
+    size_t m_tickInterval = 32;             // Bytes read between checks of the read loop clock
     std::function<void(const C110PCommand_data_led_MSGTYPE&)> m_LedCallback = nullptr;
     std::function<void(const C110PCommand_data_sound_MSGTYPE&)> m_SoundCallback = nullptr;
     std::function<void(const C110PCommand_data_move_MSGTYPE&)> m_MoveCallback = nullptr;
 
 
-    explicit ProtoFrame(Stream* stream, C110PRegion identifier = C110PRegion_REGION_UNSPECIFIED, uint32_t timeout = 1000, uint32_t maxRetries = 3)
+    explicit BasicProtoFrame(Stream* stream, C110PRegion identifier = C110PRegion_REGION_UNSPECIFIED, uint32_t timeout = Config::TIMEOUT_MS,
+                             uint32_t maxRetries = Config::MAX_RETRIES, Integrity integrity = Integrity::Crc8)
         : 
         m_regionId(identifier),
         m_stream(stream),
         m_messageTimeout(timeout), 
         m_maxRetries(maxRetries),
-        m_timestampProvider([]() -> uint64_t { 
-            return static_cast<uint64_t>(
-                std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now().time_since_epoch()
-                ).count()
-            ); 
-        }),
+        m_jitterState(0x9E3779B9u ^ static_cast<uint32_t>(identifier)),
+        m_integrity(integrity),
+        m_crcBytes(crcSize(integrity)),
+        m_timestampProvider(&Clock::now),
         m_LedCallback([](const C110PCommand_data_led_MSGTYPE&) { return; }),
         m_SoundCallback([](const C110PCommand_data_sound_MSGTYPE&) { return; }),
         m_MoveCallback([](const C110PCommand_data_move_MSGTYPE&) { return; })
     {
-        
+        resetParser();
+        if ((static_cast<uint64_t>(timeout) << maxRetries) > ReceivedIds::WINDOW)
+        {
+            C110P_TRACE_WARN("Retries span more than the duplicate window; late retransmits may run twice");
+        }
     }
 
     void reset()
     {
-        m_sentMessageBuffer.reset();
-        m_receivedMessageBuffer.reset();
-        m_messageInfoMap.clear();
-        m_inputIndex = 0;
-        m_inputLength = 0;
-        m_inputCrc = 0;
+        m_sentFrames.reset();
+        m_receivedIds.reset();
+        m_receivedSlots[m_lastReceivedSlot] = C110PCommand_init_zero;
+        m_receivedCount = 0;
+        m_pendingAckCount = 0;
+        m_pendingMessages.clear();
+        m_latestValueCount = 0;
+        for (RttEstimator& rtt : m_rtt)
+        {
+            rtt.reset();
+        }
+        resetParser();
+        m_rxStageHead = RX_STAGE_HEADROOM;
+        m_rxStageTail = RX_STAGE_HEADROOM;
+    }
+
+    // When enabled, readFrame() pulls everything available with readBytes()
+    // and runs the frame parser over the staged span instead of calling
+    // available()/read() for every byte
+    void setChunkedRead(bool enabled) {
+        m_chunkedRead = enabled;
+    }
+
+    // Receive from a byte ring filled by an ISR or reader thread instead of
+    // reading the stream; readFrame() then pops in bulk. Sends still go to
+    // the stream. nullptr goes back to reading the stream
+    void setRxRing(SpscByteRingBase* ring) {
+        m_rxRing = ring;
+    }
+
+    // Bytes ready to parse from the receive source
+    size_t rxPending() {
+        if (m_rxRing)
+        {
+            return m_rxRing->available();
+        }
+        int available = m_stream->available();
+        return available > 0 ? static_cast<size_t>(available) : 0;
+    }
+
+    // Both ends of a link must use the same format; changing it mid-stream
+    // drops any partially received frame
+    void setFrameFormat(FrameFormat format) {
+        m_frameFormat = format;
+        resetParser();
+    }
+
+    Integrity integrity() const {
+        return m_integrity;
+    }
+
+    static constexpr size_t crcSize(Integrity integrity) {
+        return integrity == Integrity::Crc32C ? 4 : (integrity == Integrity::Crc16 ? 2 : 1);
+    }
+
+    // Per region state is indexed by the region; unknown values share the
+    // REGION_UNSPECIFIED entry
+    static constexpr size_t regionIndex(C110PRegion region) {
+        return region >= _C110PRegion_MIN && region <= _C110PRegion_MAX ? region : _C110PRegion_MIN;
+    }
+
+    // Streaming frame check for the link's integrity mode: begin, update
+    // over each piece of payload, then finish. Frames are a few dozen bytes,
+    // so the byte-wise tables are used; the slicing tables would add 4-8 KiB
+    // of rodata to every image for no gain at that size
+    uint32_t crcBegin() const {
+        switch (m_integrity)
+        {
+        case Integrity::Crc16:
+            return Crc16Ccitt::begin();
+        case Integrity::Crc32C:
+            return Crc32C::begin();
+        default:
+            return Crc::begin();
+        }
+    }
+
+    uint32_t crcUpdate(uint32_t state, const uint8_t* data, size_t len) const {
+        switch (m_integrity)
+        {
+        case Integrity::Crc16:
+            return Crc16Ccitt::update(static_cast<uint16_t>(state), data, len);
+        case Integrity::Crc32C:
+            return Crc32C::update(state, data, len);
+        default:
+            return Crc::update(static_cast<typename Crc::State>(state), data, len);
+        }
+    }
+
+    uint32_t crcFinish(uint32_t state) const {
+        switch (m_integrity)
+        {
+        case Integrity::Crc16:
+            return Crc16Ccitt::finish(static_cast<uint16_t>(state));
+        case Integrity::Crc32C:
+            return Crc32C::finish(state);
+        default:
+            return Crc::finish(static_cast<typename Crc::State>(state));
+        }
+    }
+
+    // Writes the check for `state` as it goes on the wire; returns its size
+    size_t storeCrc(uint32_t state, uint8_t* dst) const {
+        uint32_t crc = crcFinish(state);
+        for (size_t i = 0; i < m_crcBytes; ++i)
+        {
+            dst[i] = static_cast<uint8_t>(crc >> (8 * i));
+        }
+        return m_crcBytes;
+    }
+
+    bool crcMatches(uint32_t state, const uint8_t* received) const {
+        uint8_t expected[CRC_MAX_BYTES];
+        storeCrc(state, expected);
+        return memcmp(expected, received, m_crcBytes) == 0;
+    }
+
+    // Largest payload the current format can frame
+    size_t maxPayloadSize() const {
+        return (m_frameFormat == FrameFormat::StartLength && MAX_SIZE - 1 > 0xFF) ? 0xFF : MAX_SIZE - 1;
+    }
+
+    // Drain mode: each drainFrames() call keeps decoding and dispatching frames
+    // until the input runs dry or either budget is used up. SIZE_MAX means
+    // no limit; the byte budget counts bytes pulled from the stream.
+    void setDrainBudget(size_t maxFrames, size_t maxBytes = SIZE_MAX) {
+        m_drainMaxFrames = maxFrames;
+        m_drainMaxBytes = maxBytes;
+    }
+
+    // Hold ACKs back for up to `delay` ms, or until `maxPending` are
+    // waiting, and acknowledge them in a single ack_batch frame. The peer
+    // must understand ack_batch. A `maxPending` of 1 (the default) sends
+    // each ACK on its own straight away; larger values are capped at
+    // ACK_BATCH_MAX. flushDueAcks() sends a batch once its delay is up
+    void setAckCoalescing(uint32_t delay, size_t maxPending) {
+        flushAcks();
+        m_ackDelay = delay;
+        m_ackBatch = maxPending < 1 ? 1 : (maxPending > ACK_BATCH_MAX ? ACK_BATCH_MAX : maxPending);
+    }
+
+    // Limit the commands waiting for an ACK to `window`; past it a send
+    // would block until ACKs, or given up retries, open the window again.
+    // At most (and by default) the sent history depth. While it is on, every
+    // command in flight keeps its frame for retries: a command whose frame
+    // would evict one still in flight, as frames longer than
+    // SENT_FRAME_BUDGET can, blocks as if the window were full. ACKs and
+    // NACKs are not counted. 0 turns the limit off: past the history depth
+    // or the arena the oldest command in flight is given up on instead
+    void setSendWindow(size_t window) {
+        m_sendWindow = window > Config::RING_DEPTH ? Config::RING_DEPTH : window;
+    }
+
+    size_t sendWindow() const {
+        return m_sendWindow;
+    }
+
+    bool sendWindowOpen() const {
+        return m_sendWindow == 0 || m_pendingMessages.size() < m_sendWindow;
+    }
+
+    // Hold ACKs for up to the coalescing delay so the next outgoing command
+    // can carry one as piggyback_ack, and no ACK frame is needed for it.
+    // The peer must understand piggyback_ack. When an ACK arrives with no
+    // room left in the batch, what is held is sent first. Set the delay
+    // with setAckCoalescing(); at 0 they still go out on the next poll
+    void setPiggybackAcks(bool enabled) {
+        if (!enabled)
+        {
+            flushAcks();
+        }
+        m_piggybackAcks = enabled;
+    }
+
+    // The latest held ACK, for an outgoing command to carry; 0 if none is
+    // held or piggybacking is off. consumePiggybackAck() once it is framed
+    uint32_t piggybackAck() const {
+        return m_piggybackAcks && m_pendingAckCount > 0 ? m_pendingAcks[m_pendingAckCount - 1] : 0;
+    }
+
+    void consumePiggybackAck() {
+        m_pendingAckCount--;
+    }
+
+    // ACKs and NACKs: never acknowledged, tracked or kept for retries
+    static bool isControl(const C110PCommand& message) {
+        return message.which_data == C110PCommand_ack_tag || message.which_data == C110PCommand_ack_batch_tag;
+    }
+
+    // Send every command of `type` (a which_data tag, e.g.
+    // C110PCommand_move_tag) as `qos`, unless the command asks for
+    // best-effort itself. Best-effort commands are not tracked, retried or
+    // held back by the send window, and the receiver does not ACK them
+    void setQos(pb_size_t type, C110PQos qos) {
+        if (type >= 32)
+        {
+            return;
+        }
+        uint32_t bit = 1u << type;
+        m_bestEffortTypes = qos == C110PQos_QOS_BEST_EFFORT ? (m_bestEffortTypes | bit) : (m_bestEffortTypes & ~bit);
+    }
+
+    // Only the latest command of `type` counts: a new one for the same
+    // target region (and actuator, for moves) supersedes any older one
+    // still waiting for an ACK, which is dropped and never retried
+    void setLatestValue(pb_size_t type, bool enabled) {
+        if (type >= 32)
+        {
+            return;
+        }
+        uint32_t bit = 1u << type;
+        m_latestValueTypes = enabled ? (m_latestValueTypes | bit) : (m_latestValueTypes & ~bit);
+    }
+
+    // Whether an older command that `message` supersedes is still waiting
+    // for an ACK, see setLatestValue()
+    bool supersedes(const C110PCommand& message) const;
+
+    // Drop that older command, and remember `message` as the latest
+    void supersede(const C110PCommand& message);
+
+    // Key `message` falls under: target region, type and actuator; 0 when
+    // every command of its type counts
+    uint32_t latestValueKey(const C110PCommand& message) const;
+
+    // Entry held for `key`, or LATEST_VALUE_KEYS if none
+    size_t latestValueEntry(uint32_t key) const;
+
+    // Class `message` goes out in: its own, or that of its type
+    C110PQos qosFor(const C110PCommand& message) const {
+        bool typeBestEffort = message.which_data < 32 && (m_bestEffortTypes >> message.which_data) & 1u;
+        return typeBestEffort ? C110PQos_QOS_BEST_EFFORT : message.qos;
     }
 
     void setTimestampProvider(uint64_t (*provider)()) {
@@ -84,6 +459,17 @@ public:
         // Safely cast uint64_t timestamp to uint32_t by taking the lower 32 bits
         return static_cast<uint32_t>(m_timestampProvider() & 0xFFFFFFFF);
     }
+
+    // The read loop only looks at the clock every `interval` bytes, using
+    // `tick` (e.g. Arduino millis()) when set and getSafeTimestamp() otherwise
+    void setTickProvider(uint32_t (*tick)(), size_t interval = 32) {
+        m_tickProvider = tick;
+        m_tickInterval = interval > 0 ? interval : 1;
+    }
+
+    uint32_t getReadTick() const {
+        return m_tickProvider ? m_tickProvider() : this->getSafeTimestamp();
+    }
     
     void setLedCallback(void (*cb)(const C110PCommand_data_led_MSGTYPE&)) {
         m_LedCallback = cb;
@@ -97,69 +483,209 @@ public:
         m_MoveCallback = cb;
     }
 
+    // Collects an encoded payload for send(), folding each piece into the
+    // CRC as nanopb writes it so the frame needs no second pass. The writer
+    // keeps its own cursor: nanopb encodes submessages through a substream
+    // sharing this state but counting bytes_written from zero
+    struct PayloadWriter {
+        const BasicProtoFrame* frame;
+        uint8_t* buffer;
+        size_t length;
+        uint32_t crc;
+    };
+
+    static bool writePayload(pb_ostream_t* stream, const pb_byte_t* buf, size_t count)
+    {
+        PayloadWriter* writer = static_cast<PayloadWriter*>(stream->state);
+        memcpy(&writer->buffer[writer->length], buf, count);
+        writer->length += count;
+        writer->crc = writer->frame->crcUpdate(writer->crc, buf, count);
+        return true;
+    }
+
+    // Records the frame without writing it; BasicC110PSerial::send() writes
     virtual bool send(const C110PCommand& message)
     {
-        m_sentMessageBuffer.add(message);
+        encodeFrame(message);
         return false;
     }
 
+    // Encode and frame `message` in the current format straight into the
+    // sent frame arena, stored under its id; control frames go to a scratch
+    // buffer instead, valid until the next one. {nullptr, 0} if it does not
+    // encode, and {nullptr, bytes needed} if the frame may not fit in `room`,
+    // or, with the send window on, only by evicting a frame still in flight
+    SentFrame encodeFrame(const C110PCommand& message, size_t room = SIZE_MAX);
+
+    // Whether a frame of `length` bytes would take the arena room of a
+    // command still waiting for its ACK; never while the window is off
+    bool evictsInFlight(size_t length) const
+    {
+        return m_sendWindow != 0 &&
+               m_sentFrames.evicts(length, [this](uint32_t id) { return m_pendingMessages.contains(id); });
+    }
+
+    bool writeFrame(const SentFrame& frame)
+    {
+        return m_stream->write(frame.data, frame.length) == frame.length;
+    }
+
     virtual bool receive(C110PCommand& message)
     {
-        m_receivedMessageBuffer.add(message);
+        if (receivedIds(message.source).check(message.id) == ReceivedIds::Result::Fresh)
+        {
+            m_lastReceivedSlot ^= 1;
+            m_receivedSlots[m_lastReceivedSlot] = message;
+            m_receivedCount++;
+        }
         return false;
     }
 
-    bool readFrame();
+    bool readFrame(size_t maxBytes = SIZE_MAX);
+
+    bool readTimeExceeded(uint32_t& startTick, size_t& nextTickCheck, size_t bytesRead) const;
+
+    size_t drainFrames();
+
+    FrameStatus parseByte(uint8_t c);
+
+    FrameStatus parseStaged();
+
+    FrameStatus parseByteCobs(uint8_t c);
+
+    FrameStatus parseStagedCobs();
+
+    FrameStatus completeCobsFrame();
+
+    FrameStatus decodeCobsFrame(uint8_t* block, size_t encoded);
+
+    void resyncFrame();
+
+    void resetParser()
+    {
+        m_inputIndex = 0;
+        m_inputLength = 0;
+        m_inputCrcState = crcBegin();
+        m_inputLengthBytes = 0;
+        m_inputOverflow = false;
+    }
 
     virtual uint32_t getSentMessageBufferSize() const
     {
-        return m_sentMessageBuffer.size();
+        return m_sentFrames.size();
     }
     
+    // Messages accepted (not duplicates) since the last reset()
     virtual uint32_t getReceivedMessageBufferSize() const
     {
-        return m_receivedMessageBuffer.size();
+        return m_receivedCount;
     }
 
     uint32_t getUnacknowledgedMessagesSize() const
     {
-        return m_messageInfoMap.size();
+        return m_pendingMessages.size();
     }
 
     uint32_t getUnacknowledgedMessage(uint32_t timestamp) const
     {
-        auto it = m_messageInfoMap.find(timestamp);
-        if (it != m_messageInfoMap.end())
-        {
-            return timestamp;
-        }
-        return 0;
+        return m_pendingMessages.contains(timestamp) ? timestamp : 0;
     }
     
     C110PCommand getLastSentMessage()
     {
-        return m_sentMessageBuffer.getCurrentValue();
+        return m_lastSent;
     }
 
     C110PCommand getLastReceivedMessage()
     {
-        return m_receivedMessageBuffer.getCurrentValue();
+        return lastReceived();
+    }
+
+    // Read-only view of the sent frames: get(id) returns the bytes written
+    const SentFrames& sentFrames() const
+    {
+        return m_sentFrames;
+    }
+
+    // The latest accepted message, without copying; valid until the next one
+    const C110PCommand& lastReceived() const
+    {
+        return m_receivedSlots[m_lastReceivedSlot];
+    }
+
+    // Ids already accepted from `source`; takes a window for it if it has
+    // none yet
+    ReceivedIds& receivedIds(C110PRegion source)
+    {
+        return m_receivedIds[static_cast<uint8_t>(regionIndex(source))];
+    }
+
+    // Round trip estimate for `peer`, from the ACKs of messages that went
+    // through on the first try
+    const RttEstimator& rtt(C110PRegion peer) const
+    {
+        return m_rtt[regionIndex(peer)];
+    }
+
+    // Current wait for an ACK from `peer` before the first retry: the
+    // measured timeout clamped to the bounds, or m_messageTimeout until
+    // there is a measurement
+    uint32_t retransmitTimeout(C110PRegion peer) const
+    {
+        const RttEstimator& estimate = rtt(peer);
+        if (!estimate.sampled())
+        {
+            return m_messageTimeout;
+        }
+        uint32_t rto = estimate.rto();
+        return rto < m_minRto ? m_minRto : (rto > m_maxRto ? m_maxRto : rto);
     }
 
+    // Bounds of the measured retransmit timeout, which also cap the
+    // backoff between retries
+    void setRetransmitBounds(uint32_t minRto, uint32_t maxRto)
+    {
+        m_minRto = minRto;
+        m_maxRto = maxRto > minRto ? maxRto : minRto;
+    }
+
+    // Wait before the next retry of a message to `peer` already retried
+    // `retries` times: the timeout doubled for each, up to the upper bound,
+    // plus up to an eighth more at random so retries of a burst spread out
+    uint32_t retryBackoff(C110PRegion peer, uint8_t retries);
+
     virtual void handleAck(uint32_t timestamp);
 
+    // ACK `timestamp`, or queue it when ACKs are coalesced
     virtual void sendAck(uint32_t timestamp);
 
+    // Send the queued ACKs now, in one frame
+    void flushAcks();
+
+    // Send the queued ACKs once the oldest has waited the coalescing delay
+    void flushDueAcks();
+
     virtual void sendNack(uint32_t timestamp, const char* reason = "Unknown");
 
     virtual void handleNack(uint32_t timestamp);
 
+    // Wait for an ACK of `timestamp`, sent (or last retried) at `sentAt`
+    void trackMessage(uint32_t timestamp, uint32_t sentAt, uint8_t retryCount = 0,
+                      C110PRegion peer = C110PRegion_REGION_UNSPECIFIED);
+
     void retryMessages();
 
-    virtual void resendMessage(C110PCommand& message);
+    virtual void resendMessage(uint32_t timestamp);
 
     void receiveMessage(const uint8_t* rawMessage, size_t length);
 
     virtual void processCallback(const C110PCommand& message);
 
 };
+
+// The default link; see ProtoFrameConfig.h for the presets
+using ProtoFrame = BasicProtoFrame<>;
+
+extern template class BasicProtoFrame<ProtoFrameConfigDefault>;
+extern template class BasicProtoFrame<ProtoFrameConfigSmall>;
+extern template class BasicProtoFrame<ProtoFrameConfigLarge>;
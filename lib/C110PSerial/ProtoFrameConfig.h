@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "DedupWindow.h"
+#include "RingBuffer.h"
+#include "TxScheduler.h"
+#include "CRC8.h"
+#include "c110p_serial.pb.h"
+
+// Default retransmit timeout and retries of a link; each retry waits twice
+// as long as the one before, so the last retransmit of a message goes out
+// up to about PROTO_FRAME_TIMEOUT_MS << PROTO_FRAME_MAX_RETRIES ms after it
+#define PROTO_FRAME_TIMEOUT_MS 1000
+#define PROTO_FRAME_MAX_RETRIES 3
+
+// Clock policies: `now()` is the default message id / timestamp source in
+// milliseconds; setTimestampProvider() still overrides it at runtime
+struct SystemClock {
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()
+            ).count()
+        );
+    }
+};
+
+struct ArduinoClock {
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(millis());
+    }
+};
+
+// CRC policies: produce the single check byte carried at the end of a frame.
+// The streaming form (begin, update over each piece, finish) lets the parser
+// fold payload bytes in as they arrive and send() as the payload is encoded
+struct Crc8Policy {
+    using State = uint8_t;
+
+    static State begin()
+    {
+        return Crc8::begin();
+    }
+
+    static State update(State state, const uint8_t* data, size_t len)
+    {
+        return Crc8::update(state, data, len);
+    }
+
+    static uint8_t finish(State state)
+    {
+        return Crc8::finish(state);
+    }
+
+    static uint8_t calculate(const uint8_t* data, size_t len)
+    {
+        return crc8.calculate(data, len);
+    }
+};
+
+// Compile-time capacities and policies for one link:
+//   MaxFrameSize: largest encoded message + 1; payloads are limited to
+//                 MaxFrameSize - 1 bytes. StartLength frames are further
+//                 capped at 255 by their one byte length field; use the
+//                 Varint format for anything larger
+//   RingDepth:    messages kept in the sent history
+//   RxStageSize:  bytes pulled from the stream per chunked read
+//   TimeoutMs:    default retransmit timeout of the link
+//   MaxRetries:   default retries of the link
+//   DedupPeers:   sources the link keeps a duplicate window for, see
+//                 DedupPeers in DedupWindow.h. Each window is sized to
+//                 cover the retry span, TimeoutMs << MaxRetries ms, since
+//                 ids are millisecond timestamps; a late retransmit would
+//                 otherwise restart the window and run again
+//   TxQueueDepth: commands BasicC110PSerial::enqueue() holds per send
+//                 class. 0 compiles the TX queue out; enqueue() then writes
+//                 at once, or returns WouldBlock
+template<size_t MaxFrameSize = 128,
+         size_t RingDepth = RING_BUFFER_SIZE,
+         size_t RxStageSize = 64,
+         typename Clock = SystemClock,
+         typename Crc = Crc8Policy,
+         uint32_t TimeoutMs = PROTO_FRAME_TIMEOUT_MS,
+         uint32_t MaxRetries = PROTO_FRAME_MAX_RETRIES,
+         size_t DedupPeers = DEDUP_WINDOW_PEERS,
+         size_t TxQueueDepth = TX_QUEUE_DEPTH>
+struct ProtoFrameConfig {
+    static_assert(MaxFrameSize > 1 && MaxFrameSize <= UINT16_MAX, "MaxFrameSize must be in 2..65535");
+    static_assert(RingDepth > 0, "RingDepth must be at least 1");
+    static_assert(RxStageSize > 0, "RxStageSize must be at least 1");
+    static_assert(MaxRetries < 32 && (static_cast<uint64_t>(TimeoutMs) << MaxRetries) <= 0x10000,
+                  "The retry span, TimeoutMs << MaxRetries, must be at most 65536 ms");
+    static_assert(DedupPeers > 0, "DedupPeers must be at least 1");
+
+    static constexpr size_t MAX_FRAME_SIZE = MaxFrameSize;
+    static constexpr size_t RING_DEPTH = RingDepth;
+    static constexpr size_t RX_STAGE_SIZE = RxStageSize;
+    static constexpr uint32_t TIMEOUT_MS = TimeoutMs;
+    static constexpr uint32_t MAX_RETRIES = MaxRetries;
+    static constexpr size_t DEDUP_BITS = dedupWindowBits(static_cast<size_t>(TimeoutMs) << MaxRetries);
+    static constexpr size_t DEDUP_PEERS = DedupPeers;
+    static constexpr size_t TX_DEPTH = TxQueueDepth;
+    using ClockPolicy = Clock;
+    using CrcPolicy = Crc;
+};
+
+// Presets; ProtoFrame.cpp and C110PSerial.cpp instantiate these
+using ProtoFrameConfigDefault = ProtoFrameConfig<>;
+using ProtoFrameConfigSmall = ProtoFrameConfig<64, 8, 16, SystemClock, Crc8Policy, PROTO_FRAME_TIMEOUT_MS,
+                                               PROTO_FRAME_MAX_RETRIES, 1, 0>;
+using ProtoFrameConfigLarge = ProtoFrameConfig<256, 256, 256, SystemClock, Crc8Policy, PROTO_FRAME_TIMEOUT_MS,
+                                               PROTO_FRAME_MAX_RETRIES, _C110PRegion_ARRAYSIZE>;
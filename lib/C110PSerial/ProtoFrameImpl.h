@@ -0,0 +1,869 @@
+#pragma once
+
+// Member definitions of BasicProtoFrame. ProtoFrame.cpp instantiates the
+// preset configs; include this from one translation unit to instantiate a
+// custom one: template class BasicProtoFrame<MyConfig>;
+#include "ProtoFrame.h"
+
+template<typename Config>
+bool BasicProtoFrame<Config>::readFrame(size_t maxBytes /* = SIZE_MAX */)
+{
+    // Bytes left over in the staging buffer, either from a previous chunked
+    // read or pushed back by a resync, come before anything still waiting in
+    // the stream
+    if (parseStaged() == FrameStatus::Complete)
+    {
+        return true;
+    }
+
+    // The clock is only checked every m_tickInterval bytes, starting once the
+    // first interval has been read; checking it per byte costs more than
+    // parsing the byte, and short reads never touch it at all
+    uint32_t timestamp = 0;
+    size_t nextTickCheck = m_tickInterval;
+    size_t bytesRead = 0;
+    if (m_chunkedRead || m_rxRing)
+    {
+        size_t available;
+        while (bytesRead < maxBytes && (available = rxPending()) > 0)
+        {
+            if (bytesRead >= nextTickCheck && readTimeExceeded(timestamp, nextTickCheck, bytesRead))
+            {
+                // Exceeded max duration, exit loop
+                break;
+            }
+
+            size_t count = available < RX_STAGE_SIZE ? available : RX_STAGE_SIZE;
+            if (count > maxBytes - bytesRead)
+            {
+                count = maxBytes - bytesRead;
+            }
+            m_rxStageHead = RX_STAGE_HEADROOM;
+            uint8_t* stage = &m_rxStage[m_rxStageHead];
+            m_rxStageTail = m_rxStageHead + (m_rxRing ? m_rxRing->pop(stage, count) : m_stream->readBytes(stage, count));
+            if (m_rxStageTail == m_rxStageHead)
+            {
+                // No data available
+                break;
+            }
+            bytesRead += m_rxStageTail - m_rxStageHead;
+            m_rxBytesRead += m_rxStageTail - m_rxStageHead;
+
+            if (parseStaged() == FrameStatus::Complete)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    while (bytesRead < maxBytes && m_stream->available())
+    {
+        if (bytesRead >= nextTickCheck && readTimeExceeded(timestamp, nextTickCheck, bytesRead))
+        {
+            // Exceeded max duration, exit loop
+            break;
+        }
+
+        // returns an int so that it can return all 255 possible 8 bit codes
+        // plus still be able to return a -1 (0xFFFF) to indicate that nothing was actually read
+        int c = m_stream->read();
+        C110P_TRACE_DEBUG("Read byte: 0x" << std::hex << c << std::dec);
+        if (c == -1)
+        {
+            // No data available
+            break;
+        }
+        bytesRead++;
+        m_rxBytesRead++;
+
+        FrameStatus status = (m_frameFormat == FrameFormat::Cobs)
+            ? parseByteCobs(static_cast<uint8_t>(c))
+            : parseByte(static_cast<uint8_t>(c));
+        if (status == FrameStatus::Invalid)
+        {
+            // The rejected bytes were pushed back; a real frame may start inside them
+            status = parseStaged();
+        }
+        if (status == FrameStatus::Complete)
+        {
+            return true;
+        }
+    }
+    C110P_TRACE_DEBUG("Exiting readFrame (no complete message)");
+    return false;
+}
+
+template<typename Config>
+bool BasicProtoFrame<Config>::readTimeExceeded(uint32_t& startTick, size_t& nextTickCheck, size_t bytesRead) const
+{
+    // The first check only records when the clock started
+    uint32_t now = getReadTick();
+    bool firstCheck = nextTickCheck == m_tickInterval;
+    nextTickCheck = bytesRead + m_tickInterval;
+    if (firstCheck)
+    {
+        startTick = now;
+        return false;
+    }
+    return now - startTick > m_messageTimeout;
+}
+
+template<typename Config>
+size_t BasicProtoFrame<Config>::drainFrames()
+{
+    size_t frames = 0;
+    size_t start = m_rxBytesRead;
+    while (frames < m_drainMaxFrames)
+    {
+        size_t used = m_rxBytesRead - start;
+        if (used >= m_drainMaxBytes || !readFrame(m_drainMaxBytes - used))
+        {
+            break;
+        }
+        frames++;
+    }
+    return frames;
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::parseStaged()
+{
+    if (m_frameFormat == FrameFormat::Cobs)
+    {
+        return parseStagedCobs();
+    }
+
+    while (m_rxStageHead < m_rxStageTail)
+    {
+        size_t staged = m_rxStageTail - m_rxStageHead;
+        if (m_inputIndex == 0)
+        {
+            // Between frames: skip straight to the next start byte candidate
+            const void* start = memchr(&m_rxStage[m_rxStageHead], static_cast<uint8_t>(START_BYTE), staged);
+            if (start == nullptr)
+            {
+                m_rxStageHead = m_rxStageTail;
+                break;
+            }
+            m_rxStageHead = static_cast<const uint8_t*>(start) - m_rxStage;
+        }
+        else if (m_inputIndex == 2 && staged >= m_inputLength + m_crcBytes && m_rxStageHead >= m_inputLengthBytes)
+        {
+            // Payload and CRC are both staged: verify and decode them in place
+            const uint8_t* data = &m_rxStage[m_rxStageHead];
+            size_t length = m_inputLength;
+            size_t lengthBytes = m_inputLengthBytes;
+            C110P_TRACE_DEBUG("verify CRC: received=[" << TraceHex(&data[length], m_crcBytes)
+                              << "], data=[" << TraceHex(data, length) << "]");
+            resetParser();
+            if (!crcMatches(crcUpdate(crcBegin(), data, length), &data[length]))
+            {
+                C110P_TRACE_WARN("CRC mismatch: resync");
+                C110P_TRACE_EVENT(TraceEvent::FrameCrcMismatch, 0, this->getSafeTimestamp());
+                // The rest of the frame is still staged, so only the length
+                // field has to go back in front of it
+                m_rxStageHead -= lengthBytes;
+                memcpy(&m_rxStage[m_rxStageHead], m_inputLengthRaw, lengthBytes);
+                continue;
+            }
+            m_rxStageHead += length + m_crcBytes;
+            receiveMessage(data, length);
+            return FrameStatus::Complete;
+        }
+        else if (m_inputIndex > 1 && m_inputIndex < m_inputLength + 2)
+        {
+            // Middle of message: copy as much of the payload as is staged in one go
+            size_t remaining = m_inputLength + 2 - m_inputIndex;
+            size_t count = remaining < staged ? remaining : staged;
+            memcpy(&m_inputBuffer[m_inputIndex - 2], &m_rxStage[m_rxStageHead], count);
+            m_inputCrcState = crcUpdate(m_inputCrcState, &m_rxStage[m_rxStageHead], count);
+            m_inputIndex += count;
+            m_rxStageHead += count;
+            continue;
+        }
+
+        // A rejected frame is pushed back into the stage, so keep scanning
+        if (parseByte(m_rxStage[m_rxStageHead++]) == FrameStatus::Complete)
+        {
+            return FrameStatus::Complete;
+        }
+    }
+    return FrameStatus::Incomplete;
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::resyncFrame()
+{
+    // Everything after the rejected start byte may still hold the start of a
+    // real frame, so push it back in front of the staged bytes: just the
+    // length field if that was rejected, otherwise [len...][data...][crc]
+    size_t lengthBytes = m_inputLengthBytes;
+    size_t count = (m_inputIndex == 1) ? lengthBytes : lengthBytes + m_inputLength + m_crcBytes;
+    if (m_rxStageHead < count)
+    {
+        size_t staged = m_rxStageTail - m_rxStageHead;
+        memmove(&m_rxStage[count], &m_rxStage[m_rxStageHead], staged);
+        m_rxStageHead = count;
+        m_rxStageTail = count + staged;
+    }
+    m_rxStageHead -= count;
+
+    uint8_t* dst = &m_rxStage[m_rxStageHead];
+    memcpy(dst, m_inputLengthRaw, lengthBytes);
+    if (m_inputIndex > 1)
+    {
+        memcpy(&dst[lengthBytes], m_inputBuffer, m_inputLength);
+        memcpy(&dst[lengthBytes + m_inputLength], m_inputCrc, m_crcBytes);
+    }
+
+    resetParser();
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::parseByte(uint8_t c)
+{
+    if (m_inputIndex == 0 && c == static_cast<uint8_t>(START_BYTE))
+    {
+        // 
+        C110P_TRACE_DEBUG("Start of new message");
+        m_inputIndex = 1;
+    }
+    else if (m_inputIndex == 1)
+    {
+        // 
+        C110P_TRACE_DEBUG("Length field follows the start byte");
+        bool valid = true;
+        m_inputLengthRaw[m_inputLengthBytes++] = c;
+        if (m_frameFormat == FrameFormat::Varint)
+        {
+            // The length may span several bytes, and several reads
+            m_inputLength |= static_cast<size_t>(c & ~Varint::CONTINUATION) << (7 * (m_inputLengthBytes - 1));
+            if (c & Varint::CONTINUATION)
+            {
+                if (m_inputLengthBytes < LENGTH_MAX_BYTES)
+                {
+                    return FrameStatus::Incomplete;
+                }
+                valid = false;
+            }
+            else if (c == 0 && m_inputLengthBytes > 1)
+            {
+                // Overlong encoding, never produced by a sender
+                valid = false;
+            }
+        }
+        else
+        {
+            m_inputLength = static_cast<size_t>(c);
+        }
+        if (!valid || m_inputLength > MAX_SIZE - 1)
+        {
+            // 
+            C110P_TRACE_WARN("Invalid length " << m_inputLength << ": resync");
+            C110P_TRACE_EVENT(TraceEvent::FrameInvalidLength, 0, this->getSafeTimestamp());
+            resyncFrame();
+            // sendNack(0, "Invalid length");
+            return FrameStatus::Invalid;
+        }
+        m_inputIndex++;
+    }
+    else if (m_inputIndex >= m_inputLength + 2)
+    {
+        // should be the CRC; the payload was folded in as it was stored
+        m_inputCrc[m_inputIndex - m_inputLength - 2] = c;
+        if (++m_inputIndex < m_inputLength + 2 + m_crcBytes)
+        {
+            return FrameStatus::Incomplete;
+        }
+        bool valid = crcMatches(m_inputCrcState, m_inputCrc);
+        C110P_TRACE_DEBUG("verify CRC: received=[" << TraceHex(m_inputCrc, m_crcBytes)
+                          << "], computed=" << crcFinish(m_inputCrcState));
+        if (!valid)
+        {
+            C110P_TRACE_WARN("CRC mismatch: resync");
+            C110P_TRACE_EVENT(TraceEvent::FrameCrcMismatch, 0, this->getSafeTimestamp());
+            resyncFrame();
+            return FrameStatus::Invalid;
+        }
+        size_t length = m_inputLength;
+        resetParser();
+        receiveMessage(m_inputBuffer, length);
+        return FrameStatus::Complete;
+    }
+    else if (m_inputIndex > 1)
+    {
+        // Middle of message
+        if (m_inputIndex - 2 < INPUT_BUFFER_SIZE)
+        {
+            m_inputBuffer[(m_inputIndex++)-2] = c;
+            m_inputCrcState = crcUpdate(m_inputCrcState, &c, 1);
+        }
+        else
+        {
+            // 
+            C110P_TRACE_WARN("Buffer overflow: reset");
+            C110P_TRACE_EVENT(TraceEvent::FrameOverflow, 0, this->getSafeTimestamp());
+            resetParser();
+            // sendNack(0, "Input buffer overflow");
+        }
+    }
+    return FrameStatus::Incomplete;
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::parseStagedCobs()
+{
+    while (m_rxStageHead < m_rxStageTail)
+    {
+        // Everything up to the next delimiter belongs to the current frame
+        size_t staged = m_rxStageTail - m_rxStageHead;
+        const void* delimiter = memchr(&m_rxStage[m_rxStageHead], COBS::DELIMITER, staged);
+        size_t count = delimiter
+            ? static_cast<size_t>(static_cast<const uint8_t*>(delimiter) - &m_rxStage[m_rxStageHead])
+            : staged;
+
+        if (delimiter && m_inputIndex == 0 && !m_inputOverflow && count <= COBS_MAX_SIZE)
+        {
+            // The whole frame is staged: decode it in place
+            uint8_t* block = &m_rxStage[m_rxStageHead];
+            m_rxStageHead += count + 1;
+            if (decodeCobsFrame(block, count) == FrameStatus::Complete)
+            {
+                return FrameStatus::Complete;
+            }
+            continue;
+        }
+
+        if (!m_inputOverflow && m_inputIndex + count <= COBS_MAX_SIZE)
+        {
+            memcpy(&m_inputBuffer[m_inputIndex], &m_rxStage[m_rxStageHead], count);
+            m_inputIndex += count;
+        }
+        else if (!m_inputOverflow)
+        {
+            C110P_TRACE_WARN("Buffer overflow: discard until delimiter");
+            C110P_TRACE_EVENT(TraceEvent::FrameOverflow, 0, this->getSafeTimestamp());
+            m_inputOverflow = true;
+        }
+        m_rxStageHead += count;
+
+        if (delimiter)
+        {
+            m_rxStageHead++;
+            if (completeCobsFrame() == FrameStatus::Complete)
+            {
+                return FrameStatus::Complete;
+            }
+        }
+    }
+    return FrameStatus::Incomplete;
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::parseByteCobs(uint8_t c)
+{
+    if (c == COBS::DELIMITER)
+    {
+        return completeCobsFrame();
+    }
+    if (m_inputOverflow)
+    {
+        return FrameStatus::Incomplete;
+    }
+    if (m_inputIndex >= COBS_MAX_SIZE)
+    {
+        C110P_TRACE_WARN("Buffer overflow: discard until delimiter");
+        C110P_TRACE_EVENT(TraceEvent::FrameOverflow, 0, this->getSafeTimestamp());
+        m_inputOverflow = true;
+        return FrameStatus::Incomplete;
+    }
+    m_inputBuffer[m_inputIndex++] = c;
+    return FrameStatus::Incomplete;
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::completeCobsFrame()
+{
+    // A delimiter always ends the frame, so the next byte is a clean resync point
+    size_t encoded = m_inputIndex;
+    bool overflow = m_inputOverflow;
+    m_inputIndex = 0;
+    m_inputOverflow = false;
+    if (overflow)
+    {
+        return FrameStatus::Invalid;
+    }
+    return decodeCobsFrame(m_inputBuffer, encoded);
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::FrameStatus BasicProtoFrame<Config>::decodeCobsFrame(uint8_t* block, size_t encoded)
+{
+    if (encoded == 0)
+    {
+        // Empty blocks are back to back delimiters, e.g. idle line fill
+        return FrameStatus::Incomplete;
+    }
+
+    // Decode in place, the result is [data...][crc]
+    size_t decoded = COBS::decode(block, encoded, block);
+    if (decoded <= m_crcBytes || decoded - m_crcBytes > MAX_SIZE - 1)
+    {
+        C110P_TRACE_WARN("Invalid COBS block: " << encoded << " bytes");
+        C110P_TRACE_EVENT(TraceEvent::FrameInvalidLength, 0, this->getSafeTimestamp());
+        return FrameStatus::Invalid;
+    }
+    size_t length = decoded - m_crcBytes;
+    C110P_TRACE_DEBUG("verify CRC: received=[" << TraceHex(&block[length], m_crcBytes)
+                      << "], data=[" << TraceHex(block, length) << "]");
+    if (!crcMatches(crcUpdate(crcBegin(), block, length), &block[length]))
+    {
+        C110P_TRACE_WARN("CRC mismatch: drop frame");
+        C110P_TRACE_EVENT(TraceEvent::FrameCrcMismatch, 0, this->getSafeTimestamp());
+        return FrameStatus::Invalid;
+    }
+    receiveMessage(block, length);
+    return FrameStatus::Complete;
+}
+
+template<typename Config>
+typename BasicProtoFrame<Config>::SentFrame BasicProtoFrame<Config>::encodeFrame(const C110PCommand& message, size_t room /* = SIZE_MAX */)
+{
+    // Payloads are limited to MAX_SIZE - 1 bytes by the receiver (255 for
+    // StartLength); the spare room holds the crc
+    uint8_t block[FRAME_BODY_MAX_SIZE];
+    PayloadWriter writer = {this, block, 0, crcBegin()};
+    pb_ostream_t stream = {&writePayload, &writer, maxPayloadSize(), 0, nullptr};
+    if (!pb_encode(&stream, C110PCommand_fields, &message))
+    {
+        C110P_TRACE_ERROR("Failed to encode C110PCommand message: " << PB_GET_ERROR(&stream));
+        C110P_TRACE_EVENT(TraceEvent::EncodeFailed, message.id, this->getSafeTimestamp());
+        return {nullptr, 0};
+    }
+
+    size_t len = writer.length;
+    size_t crcLen = storeCrc(writer.crc, &block[len]);
+    C110P_TRACE_DEBUG("Sending data: [" << TraceHex(block, len) << "] LEN: " << len
+                      << " CRC: " << TraceHex(&block[len], crcLen));
+    // Only the room the frame needs is taken from the arena, so a short
+    // frame evicts no more than it has to
+    bool keep = !isControl(message) && message.qos != C110PQos_QOS_BEST_EFFORT;
+    uint8_t* frame;
+    size_t frameLen;
+    if (m_frameFormat == FrameFormat::Cobs)
+    {
+        // Stuff [data...][crc] as one block and terminate it with the delimiter
+        size_t maxLen = COBS::maxEncodedSize(len + crcLen) + 1;
+        if (maxLen > room || (keep && evictsInFlight(maxLen)))
+        {
+            return {nullptr, maxLen};
+        }
+        frame = keep ? m_sentFrames.reserve(maxLen) : m_scratchFrame;
+        frameLen = COBS::encode(block, len + crcLen, frame);
+        frame[frameLen++] = COBS::DELIMITER;
+    }
+    else
+    {
+        uint8_t header[1 + LENGTH_MAX_BYTES] = {static_cast<uint8_t>(START_BYTE), static_cast<uint8_t>(len)};
+        size_t headerLen = 2;
+        if (m_frameFormat == FrameFormat::Varint)
+        {
+            headerLen = 1 + Varint::encode(len, &header[1]);
+        }
+        frameLen = headerLen + len + crcLen;
+        if (frameLen > room || (keep && evictsInFlight(frameLen)))
+        {
+            return {nullptr, frameLen};
+        }
+        frame = keep ? m_sentFrames.reserve(frameLen) : m_scratchFrame;
+        memcpy(frame, header, headerLen);
+        memcpy(&frame[headerLen], block, len + crcLen);
+    }
+    if (keep)
+    {
+        m_sentFrames.commit(message.id, frameLen);
+    }
+    m_lastSent = message;
+    return {frame, frameLen};
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::handleAck(uint32_t timestamp)
+{
+    C110P_TRACE_DEBUG("handleAck: " << timestamp);
+    MessageInfo* info = m_pendingMessages.find(timestamp);
+    if (!info)
+    {
+        return;
+    }
+    // Only a message that went through on the first try gives a sample:
+    // after a retry the ACK could answer either copy (Karn's algorithm)
+    if (info->retryCount == 0)
+    {
+        m_rtt[info->peer].sample(this->getSafeTimestamp() - info->lastProcessedTimestamp);
+    }
+    m_pendingMessages.remove(timestamp);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::sendAck(uint32_t timestamp)
+{
+    if (m_ackBatch > 1 || m_piggybackAcks)
+    {
+        for (size_t i = 0; i < m_pendingAckCount; ++i)
+        {
+            if (m_pendingAcks[i] == timestamp)
+            {
+                return;
+            }
+        }
+        if (m_pendingAckCount >= m_ackBatch)
+        {
+            // Only when piggybacking: the batch is kept full for the next command
+            flushAcks();
+        }
+        if (m_pendingAckCount == 0)
+        {
+            m_pendingAckSince = this->getSafeTimestamp();
+        }
+        m_pendingAcks[m_pendingAckCount++] = timestamp;
+        if (!m_piggybackAcks && m_pendingAckCount >= m_ackBatch)
+        {
+            flushAcks();
+        }
+        return;
+    }
+
+    AckCommand ack = AckCommand_init_zero;
+    ack.acknowledged = true;
+    C110PCommand msg = C110PCommand_init_default;
+    msg.id = timestamp;
+    msg.source = m_regionId;
+    msg.which_data = C110PCommand_ack_tag;
+    msg.data.ack = ack;
+    send(msg);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::flushAcks()
+{
+    if (m_pendingAckCount == 0)
+    {
+        return;
+    }
+    C110PCommand msg = C110PCommand_init_default;
+    msg.id = m_pendingAcks[0];
+    msg.source = m_regionId;
+    if (m_pendingAckCount == 1)
+    {
+        // A lone ACK in the plain form
+        msg.which_data = C110PCommand_ack_tag;
+        msg.data.ack.acknowledged = true;
+    }
+    else
+    {
+        msg.which_data = C110PCommand_ack_batch_tag;
+        AckBatchCommand& batch = msg.data.ack_batch;
+        batch.offsets_count = static_cast<pb_size_t>(m_pendingAckCount - 1);
+        for (size_t i = 1; i < m_pendingAckCount; ++i)
+        {
+            batch.offsets[i - 1] = static_cast<int32_t>(m_pendingAcks[i] - m_pendingAcks[0]);
+        }
+    }
+    m_pendingAckCount = 0;
+    send(msg);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::flushDueAcks()
+{
+    if (m_pendingAckCount > 0 && this->getSafeTimestamp() - m_pendingAckSince >= m_ackDelay)
+    {
+        flushAcks();
+    }
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::sendNack(uint32_t timestamp, const char* reason /* = "Unknown" */)
+{
+    AckCommand ack = AckCommand_init_default;
+    ack.acknowledged = false;
+    strncpy(ack.reason, reason, sizeof(ack.reason) - 1);
+    // // Set up the callback to encode the reason string
+    // ack.reason.funcs.encode = [](pb_ostream_t *stream, const pb_field_t *field, void * const *arg) -> bool {
+    //     const char* str = static_cast<const char*>(*arg);
+    //     return pb_encode_tag_for_field(stream, field) &&
+    //            pb_encode_string(stream, (const uint8_t*)str, strlen(str));
+    // };
+    // ack.reason.arg = (void*)reason;
+    C110PCommand msg = C110PCommand_init_default;
+    msg.id = timestamp;
+    msg.source = m_regionId;
+    msg.which_data = C110PCommand_ack_tag;
+    msg.data.ack = ack;
+    send(msg);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::handleNack(uint32_t timestamp)
+{
+    // For now, treat NACK like a retriable failure
+    if (m_sentFrames.contains(timestamp) && m_pendingMessages.contains(timestamp))
+    {
+        resendMessage(timestamp);
+    }
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::trackMessage(uint32_t timestamp, uint32_t sentAt, uint8_t retryCount /* = 0 */,
+                                           C110PRegion peer /* = C110PRegion_REGION_UNSPECIFIED */)
+{
+    MessageInfo info = {sentAt, retryCount, static_cast<uint8_t>(regionIndex(peer))};
+    uint32_t deadline = sentAt + (retryCount == 0 ? retransmitTimeout(peer) : retryBackoff(peer, retryCount));
+    uint32_t evicted;
+    if (m_pendingMessages.schedule(timestamp, info, deadline, &evicted))
+    {
+        // More messages in flight than frames held; the oldest could not
+        // have been retried much longer anyway
+        C110P_TRACE_WARN("Too many unacknowledged messages, giving up on: " << evicted);
+        C110P_TRACE_EVENT(TraceEvent::RetryExhausted, evicted, sentAt);
+    }
+}
+
+template<typename Config>
+uint32_t BasicProtoFrame<Config>::latestValueKey(const C110PCommand& message) const
+{
+    if (message.which_data >= 32 || !((m_latestValueTypes >> message.which_data) & 1u))
+    {
+        return 0;
+    }
+    // which_data is never 0 for a command, so neither is the key
+    uint32_t actuator = message.which_data == C110PCommand_move_tag ? message.data.move.target : 0;
+    return (static_cast<uint32_t>(regionIndex(message.target)) << 16) | (message.which_data << 8) | actuator;
+}
+
+template<typename Config>
+size_t BasicProtoFrame<Config>::latestValueEntry(uint32_t key) const
+{
+    for (size_t i = 0; i < m_latestValueCount; ++i)
+    {
+        if (m_latestValues[i].key == key)
+        {
+            return i;
+        }
+    }
+    return LATEST_VALUE_KEYS;
+}
+
+template<typename Config>
+bool BasicProtoFrame<Config>::supersedes(const C110PCommand& message) const
+{
+    uint32_t key = latestValueKey(message);
+    size_t i = key != 0 ? latestValueEntry(key) : LATEST_VALUE_KEYS;
+    return i < LATEST_VALUE_KEYS && m_latestValues[i].id != message.id &&
+           m_pendingMessages.contains(m_latestValues[i].id);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::supersede(const C110PCommand& message)
+{
+    uint32_t key = latestValueKey(message);
+    if (key == 0)
+    {
+        return;
+    }
+    size_t i = latestValueEntry(key);
+    if (i == LATEST_VALUE_KEYS)
+    {
+        i = m_latestValueCount;
+        if (m_latestValueCount < LATEST_VALUE_KEYS)
+        {
+            m_latestValueCount++;
+        }
+        else
+        {
+            // More keys than entries: forget one, at worst leaving its last
+            // command to be retried
+            i = m_latestValueNext;
+            m_latestValueNext = (m_latestValueNext + 1) % LATEST_VALUE_KEYS;
+        }
+        m_latestValues[i].key = key;
+    }
+    else if (m_latestValues[i].id != message.id && m_pendingMessages.remove(m_latestValues[i].id))
+    {
+        C110P_TRACE_DEBUG("Superseded message: " << m_latestValues[i].id << " by " << message.id);
+        C110P_TRACE_EVENT(TraceEvent::Superseded, m_latestValues[i].id, this->getSafeTimestamp());
+    }
+    m_latestValues[i].id = message.id;
+}
+
+template<typename Config>
+uint32_t BasicProtoFrame<Config>::retryBackoff(C110PRegion peer, uint8_t retries)
+{
+    uint32_t base = retransmitTimeout(peer);
+    uint32_t cap = base > m_maxRto ? base : m_maxRto;
+    uint32_t wait = base;
+    for (uint8_t i = 0; i < retries && wait < cap; ++i)
+    {
+        wait <<= 1;
+    }
+    if (wait > cap)
+    {
+        wait = cap;
+    }
+    m_jitterState ^= m_jitterState << 13;
+    m_jitterState ^= m_jitterState >> 17;
+    m_jitterState ^= m_jitterState << 5;
+    return wait + m_jitterState % (wait / 8 + 1);
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::retryMessages()
+{
+    uint32_t currentTime = this->getSafeTimestamp();
+    // Only the messages whose retry deadline has passed come out of the wheel
+    m_pendingMessages.poll(currentTime, [this, currentTime](uint32_t timestamp, MessageInfo& info) {
+        if (info.retryCount >= m_maxRetries || !m_sentFrames.contains(timestamp))
+        {
+            // Out of retries, or its frame has been evicted from the arena
+            C110P_TRACE_WARN("Max retries reached for message with timestamp: " << timestamp);
+            C110P_TRACE_EVENT(TraceEvent::RetryExhausted, timestamp, currentTime);
+            m_pendingMessages.remove(timestamp);
+            return;
+        }
+        C110P_TRACE_INFO("Retrying message with timestamp: " << timestamp);
+        C110P_TRACE_EVENT(TraceEvent::Retry, timestamp, currentTime);
+        resendMessage(timestamp);
+    });
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::resendMessage(uint32_t timestamp)
+{
+    MessageInfo* info = m_pendingMessages.find(timestamp);
+    if (info)
+    {
+        uint32_t now = this->getSafeTimestamp();
+        info->lastProcessedTimestamp = now;
+        info->retryCount++;
+        uint32_t wait = retryBackoff(static_cast<C110PRegion>(info->peer), info->retryCount);
+        m_pendingMessages.reschedule(timestamp, now + wait);
+    }
+    // The frame as first written; no encoding or CRC work
+    SentFrame frame = m_sentFrames.get(timestamp);
+    if (frame.data)
+    {
+        writeFrame(frame);
+    }
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::receiveMessage(const uint8_t* rawMessage, size_t length)
+{
+    // Decode straight into the spare slot; it only becomes the latest
+    // message once it is known not to be a duplicate
+    C110PCommand& msg = m_receivedSlots[m_lastReceivedSlot ^ 1];
+
+    pb_istream_t stream = pb_istream_from_buffer(rawMessage, length);
+    if (!pb_decode(&stream, C110PCommand_fields, &msg))
+    {
+        C110P_TRACE_WARN("Failed to decode C110PCommand message: " << PB_GET_ERROR(&stream));
+        C110P_TRACE_EVENT(TraceEvent::DecodeFailed, 0, this->getSafeTimestamp());
+        // sendNack(0, "Protobuf decode failed");
+        return;
+    }
+    C110P_TRACE_DEBUG("Received message: " << msg.id);
+    C110P_TRACE_EVENT(TraceEvent::FrameReceived, msg.id, this->getSafeTimestamp());
+
+    // An ACK carried by the command holds whether or not the command itself
+    // is new
+    if (msg.piggyback_ack != 0)
+    {
+        C110P_TRACE_EVENT(TraceEvent::AckReceived, msg.piggyback_ack, this->getSafeTimestamp());
+        handleAck(msg.piggyback_ack);
+    }
+
+    // An ACK carries the id of the acknowledged message, from our own clock,
+    // so it stays out of the sender's window; handling it twice is harmless
+    using Result = typename ReceivedIds::Result;
+    bool isAck = isControl(msg);
+    Result seen = isAck ? Result::Fresh : receivedIds(msg.source).check(msg.id);
+    if (seen == Result::Duplicate)
+    {
+        C110P_TRACE_EVENT(TraceEvent::DuplicateReceived, msg.id, this->getSafeTimestamp());
+        // Duplicate message: already processed, just re-ACK
+        if (msg.qos != C110PQos_QOS_BEST_EFFORT)
+        {
+            sendAck(msg.id);
+        }
+    }
+    else
+    {
+        m_lastReceivedSlot ^= 1;
+        m_receivedCount++;
+        // ACKs and NACKs are not acknowledged themselves, or the two ends
+        // would keep acknowledging each other's ACKs; nor is best-effort
+        if (!isAck && msg.qos != C110PQos_QOS_BEST_EFFORT)
+        {
+            sendAck(msg.id);
+        }
+        processCallback(msg);
+    }
+}
+
+template<typename Config>
+void BasicProtoFrame<Config>::processCallback(const C110PCommand& message)
+{
+    C110P_TRACE_DEBUG("processCallback: which_data=" << message.which_data);
+    switch(message.which_data)
+    {
+        case C110PCommand_ack_tag:
+            if (message.data.ack.acknowledged)
+            {
+                C110P_TRACE_DEBUG("Received ACK for timestamp: " << message.id);
+                C110P_TRACE_EVENT(TraceEvent::AckReceived, message.id, this->getSafeTimestamp());
+                handleAck(message.id);
+            }
+            else
+            {
+                C110P_TRACE_DEBUG("Received NACK for timestamp: " << message.id);
+                C110P_TRACE_EVENT(TraceEvent::NackReceived, message.id, this->getSafeTimestamp());
+                handleNack(message.id);
+            }
+            break;
+        case C110PCommand_ack_batch_tag:
+            // Every covered message is cleared in this one pass
+            C110P_TRACE_DEBUG("Received ACK batch of " << (message.data.ack_batch.offsets_count + 1) << " from: " << message.id);
+            C110P_TRACE_EVENT(TraceEvent::AckReceived, message.id, this->getSafeTimestamp());
+            handleAck(message.id);
+            for (pb_size_t i = 0; i < message.data.ack_batch.offsets_count; ++i)
+            {
+                uint32_t timestamp = message.id + static_cast<uint32_t>(message.data.ack_batch.offsets[i]);
+                C110P_TRACE_EVENT(TraceEvent::AckReceived, timestamp, this->getSafeTimestamp());
+                handleAck(timestamp);
+            }
+            break;
+        case C110PCommand_led_tag:
+            if (m_LedCallback)
+            {
+                m_LedCallback(message.data.led);
+            }
+            break;
+        case C110PCommand_move_tag:
+            if (m_MoveCallback)
+            {
+                m_MoveCallback(message.data.move);
+            }
+            break;
+        case C110PCommand_sound_tag:
+            if (m_SoundCallback)
+            {
+                m_SoundCallback(message.data.sound);
+            }
+            break;
+        default:
+            // Console.println("Unknown message type");
+            break;
+    }
+}
\ No newline at end of file
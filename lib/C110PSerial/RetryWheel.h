@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "IdIndex.h"
+
+// Wheel geometry: RETRY_WHEEL_SLOTS slots of 2^RETRY_WHEEL_TICK_SHIFT ms,
+// so one turn spans 64 * 16 = 1024 ms, just over the default timeout
+#define RETRY_WHEEL_SLOTS 64
+#define RETRY_WHEEL_TICK_SHIFT 4
+
+// Hashed timer wheel of the messages waiting for an ACK, keyed by the
+// millisecond deadline of their next retry. poll() only visits the slots
+// of the ticks that have passed since the last poll, so it touches the
+// entries that are due rather than every message in flight; entries due
+// more than a turn ahead share a slot and are passed over until then.
+//
+// Entries live in a fixed pool of Capacity, linked into a doubly linked
+// list per slot and found by id through an IdIndex, so scheduling and
+// removal (on ACK) are O(1) and nothing is allocated. A deadline fires on
+// the first poll after its tick has ended, up to one tick late.
+template<typename T, size_t Capacity, size_t Slots = RETRY_WHEEL_SLOTS, size_t TickShift = RETRY_WHEEL_TICK_SHIFT>
+class RetryWheel
+{
+    static_assert(Capacity > 0, "Capacity must be at least 1");
+    static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+    static_assert(TickShift < 32, "TickShift must be below 32");
+
+public:
+    RetryWheel()
+    {
+        clear();
+    }
+
+    // Add `id`, or move it if already held, to fire at `deadline` with
+    // `value`. When the wheel is full the entry due first is dropped to
+    // make room; returns true then, with its id in `evicted`
+    bool schedule(uint32_t id, const T& value, uint32_t deadline, uint32_t* evicted = nullptr)
+    {
+        Link node = m_index.find(id);
+        bool dropped = false;
+        if (node == NONE)
+        {
+            if (m_free == NONE)
+            {
+                Link first = earliest();
+                if (evicted)
+                {
+                    *evicted = m_nodes[first].id;
+                }
+                release(first);
+                dropped = true;
+            }
+            node = m_free;
+            m_free = m_nodes[node].next;
+            m_nodes[node].id = id;
+            m_nodes[node].list = DETACHED;
+            m_index.insert(id, node);
+            ++m_size;
+        }
+        m_nodes[node].value = value;
+        place(node, deadline);
+        return dropped;
+    }
+
+    // Move `id` to fire at `deadline`; returns false if it is not held
+    bool reschedule(uint32_t id, uint32_t deadline)
+    {
+        Link node = m_index.find(id);
+        if (node == NONE)
+        {
+            return false;
+        }
+        place(node, deadline);
+        return true;
+    }
+
+    // Drop `id`, e.g. once it has been acknowledged
+    bool remove(uint32_t id)
+    {
+        Link node = m_index.find(id);
+        if (node == NONE)
+        {
+            return false;
+        }
+        release(node);
+        return true;
+    }
+
+    T* find(uint32_t id)
+    {
+        Link node = m_index.find(id);
+        return node != NONE ? &m_nodes[node].value : nullptr;
+    }
+
+    const T* find(uint32_t id) const
+    {
+        Link node = m_index.find(id);
+        return node != NONE ? &m_nodes[node].value : nullptr;
+    }
+
+    bool contains(uint32_t id) const
+    {
+        return m_index.find(id) != NONE;
+    }
+
+    // Deadline of `id`; only meaningful when it is held
+    uint32_t deadline(uint32_t id) const
+    {
+        return m_nodes[m_index.find(id)].deadline;
+    }
+
+    uint32_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < LISTS; ++i)
+        {
+            m_heads[i] = NONE;
+        }
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            m_nodes[i].list = FREE;
+            m_nodes[i].next = static_cast<Link>(i + 1 < Capacity ? i + 1 : NONE);
+        }
+        m_free = 0;
+        m_size = 0;
+        m_index.clear();
+        m_tick = 0;
+        m_started = false;
+    }
+
+    // Call `onDue(id, value)` for every entry whose deadline is at or
+    // before `now`. Each is taken off the wheel first: the callback moves
+    // it on with schedule() / reschedule() or drops it with remove(), and
+    // an entry it leaves alone is dropped. It may change other entries too
+    template<typename F>
+    void poll(uint32_t now, F&& onDue)
+    {
+        uint32_t tick = now >> TickShift;
+        if (!m_started)
+        {
+            // Entries added before the first poll went in by deadline alone
+            sweep(0, Slots, now);
+            m_started = true;
+        }
+        else
+        {
+            // Ticks are 32 - TickShift bits wide; mask so the difference
+            // survives a wrap of the millisecond clock
+            uint32_t passed = (tick - m_tick) & TICK_MASK;
+            if (passed == 0 || passed > (TICK_MASK >> 1))
+            {
+                return;
+            }
+            sweep(m_tick, passed < Slots ? passed : Slots, now);
+        }
+        m_tick = tick;
+
+        while (m_heads[DUE] != NONE)
+        {
+            Link node = m_heads[DUE];
+            unlink(node);
+            m_nodes[node].list = DETACHED;
+            onDue(m_nodes[node].id, m_nodes[node].value);
+            if (m_nodes[node].list == DETACHED)
+            {
+                release(node);
+            }
+        }
+    }
+
+private:
+    using Link = typename IdIndex<Capacity>::Slot;
+    static constexpr Link NONE = IdIndex<Capacity>::NONE;
+
+    // List numbers: one per slot, then the entries found due by poll()
+    static constexpr size_t DUE = Slots;
+    static constexpr size_t LISTS = Slots + 1;
+    using List = typename std::conditional<(Slots + 2 < UINT16_MAX), uint16_t, uint32_t>::type;
+    static constexpr List DETACHED = static_cast<List>(Slots + 1);  // Held, in no list
+    static constexpr List FREE = static_cast<List>(Slots + 2);
+    static constexpr uint32_t TICK_MASK = 0xFFFFFFFFu >> TickShift;
+
+    struct Node {
+        uint32_t id;
+        uint32_t deadline;
+        T value;
+        Link prev;
+        Link next;
+        List list;
+    };
+
+    static bool before(uint32_t a, uint32_t b)
+    {
+        return static_cast<int32_t>(a - b) < 0;
+    }
+
+    void place(Link node, uint32_t deadline)
+    {
+        if (m_nodes[node].list != DETACHED)
+        {
+            unlink(node);
+        }
+        m_nodes[node].deadline = deadline;
+        // Anything already overdue goes in the current slot, the next one
+        // poll() visits
+        uint32_t tick = deadline >> TickShift;
+        if (m_started && before(deadline, m_tick << TickShift))
+        {
+            tick = m_tick;
+        }
+        link(node, tick & (Slots - 1));
+    }
+
+    void link(Link node, size_t list)
+    {
+        m_nodes[node].list = static_cast<List>(list);
+        m_nodes[node].prev = NONE;
+        m_nodes[node].next = m_heads[list];
+        if (m_heads[list] != NONE)
+        {
+            m_nodes[m_heads[list]].prev = node;
+        }
+        m_heads[list] = node;
+    }
+
+    void unlink(Link node)
+    {
+        Node& n = m_nodes[node];
+        if (n.prev != NONE)
+        {
+            m_nodes[n.prev].next = n.next;
+        }
+        else
+        {
+            m_heads[n.list] = n.next;
+        }
+        if (n.next != NONE)
+        {
+            m_nodes[n.next].prev = n.prev;
+        }
+    }
+
+    void release(Link node)
+    {
+        if (m_nodes[node].list != DETACHED)
+        {
+            unlink(node);
+        }
+        m_index.erase(m_nodes[node].id);
+        m_nodes[node].list = FREE;
+        m_nodes[node].next = m_free;
+        m_free = node;
+        --m_size;
+    }
+
+    // Move the due entries of `count` slots from the one of `tick` on to
+    // the due list
+    void sweep(uint32_t tick, size_t count, uint32_t now)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Link node = m_heads[(tick + i) & (Slots - 1)];
+            while (node != NONE)
+            {
+                Link next = m_nodes[node].next;
+                if (!before(now, m_nodes[node].deadline))
+                {
+                    unlink(node);
+                    link(node, DUE);
+                }
+                node = next;
+            }
+        }
+    }
+
+    // Held entry with the nearest deadline; only called when full, so the
+    // scan over the pool is off the common path
+    Link earliest() const
+    {
+        Link best = NONE;
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            if (m_nodes[i].list != FREE &&
+                (best == NONE || before(m_nodes[i].deadline, m_nodes[best].deadline)))
+            {
+                best = static_cast<Link>(i);
+            }
+        }
+        return best;
+    }
+
+    Node m_nodes[Capacity];
+    Link m_heads[LISTS];
+    Link m_free;
+    uint32_t m_size;
+    IdIndex<Capacity> m_index;  // id -> node
+    uint32_t m_tick;            // Tick of the last poll; its slot is not swept yet
+    bool m_started;
+};
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include "IdIndex.h"
 
 #define RING_BUFFER_SIZE 25
 
-template<typename T>
+// N is fixed at compile time so the wrap arithmetic folds to constants.
+// Messages are found by id through a fixed-size open addressing index
+// (IdIndex.h) that holds each message's slot, so nothing is allocated
+// after construction
+template<typename T, size_t N = RING_BUFFER_SIZE>
 class RingBuffer
 {
 public:
@@ -16,7 +25,6 @@ public:
         m_tail(0), 
         m_size(0)
     {
-
     }
 
     // Function to reset the ring buffer
@@ -25,65 +33,192 @@ public:
         m_head = 0;
         m_tail = 0;
         m_size = 0;
-        m_messageMap.clear();
+        m_index.clear();
     }
 
     // Function to add a new message to the buffer
     void add(const T& message)
     {
-        uint32_t timestamp = message.id; // Assumes T has id
-        if (contains(timestamp))
+        if (contains(message.id)) // Assumes T has id
         {
             return;
         }
+        prepare() = message;
+        commit();
+    }
+
+    // Slot the next message will be stored in, so it can be built in place.
+    // The slot never holds a stored message, so writing to it is safe even
+    // when the buffer is full; it only becomes visible after commit()
+    T& prepare()
+    {
+        return m_buffer[m_head];
+    }
 
-        if (m_size < RING_BUFFER_SIZE)
+    // Store the prepared slot, evicting the oldest message once full.
+    // Returns false, leaving the buffer untouched, if its id is already held
+    bool commit()
+    {
+        uint32_t timestamp = m_buffer[m_head].id; // Assumes T has id
+        if (contains(timestamp))
+        {
+            return false;
+        }
+
+        if (m_size < static_cast<int>(N))
         {
             ++m_size;
         }
         else
         {
-            // Remove the oldest message from the map
-            m_messageMap.erase(m_buffer[m_tail].id);
-            m_tail = (m_tail + 1) % RING_BUFFER_SIZE;
+            evictOldest();
         }
-        m_buffer[m_head] = message;
-        m_messageMap[timestamp] = true;
-        m_head = (m_head + 1) % RING_BUFFER_SIZE;
+        m_index.insert(timestamp, static_cast<Slot>(m_head));
+        m_head = (m_head + 1) % RING_BUFFER_SLOTS;
+        return true;
+    }
+
+    // Remove the oldest message; does nothing when empty
+    void dropOldest()
+    {
+        if (m_size > 0)
+        {
+            evictOldest();
+            --m_size;
+        }
+    }
+
+    // Stop finding `id` by get() and contains(), so the same id can be
+    // stored again. Its slot keeps its place in the order (and in size())
+    // until it is evicted
+    void forget(uint32_t id)
+    {
+        m_index.erase(id);
     }
     
     // Function to check if the message timestamp already exists in the buffer
-    bool contains(uint32_t timestamp)
+    bool contains(uint32_t timestamp) const
     {
-        return m_messageMap.find(timestamp) != m_messageMap.end();
+        return m_index.find(timestamp) != IdIndex<N>::NONE;
     }
 
     // Function to get the Message by timestamp
     T* get(uint32_t timestamp)
     {
-        for (int i = 0; i < m_size; ++i) {
-            int idx = (m_tail + i) % RING_BUFFER_SIZE;
-            if (m_buffer[idx].id == timestamp) {
-                return &m_buffer[idx];
-            }
+        Slot slot = m_index.find(timestamp);
+        return slot != IdIndex<N>::NONE ? &m_buffer[slot] : nullptr;
+    }
+
+    const T* get(uint32_t timestamp) const
+    {
+        Slot slot = m_index.find(timestamp);
+        return slot != IdIndex<N>::NONE ? &m_buffer[slot] : nullptr;
+    }
+
+    // Oldest stored message; only meaningful when not empty()
+    const T& oldest() const
+    {
+        return m_buffer[m_tail];
+    }
+
+    // Most recently stored message, or a value initialized T when empty.
+    // The reference stays valid until the slot is reused N adds later
+    const T& latest() const
+    {
+        static const T empty{};
+        if (m_size == 0)
+        {
+            return empty;
         }
-        return nullptr;
+        int idx = (m_head == 0) ? (RING_BUFFER_SLOTS - 1) : (m_head - 1);
+        return m_buffer[idx];
     }
 
     // Function to get the value at the current position (head - 1)
     T getCurrentValue() const
     {
-        if (m_size == 0)
+        return latest();
+    }
+
+    // Oldest to newest iteration over the stored messages, without copying.
+    // Adding to the buffer invalidates iterators
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const RingBuffer* ring, int position)
+            : m_ring(ring), m_position(position)
         {
-            return T{};
         }
-        int idx = (m_head == 0) ? (RING_BUFFER_SIZE - 1) : (m_head - 1);
-        return m_buffer[idx];
+
+        reference operator*() const
+        {
+            return m_ring->m_buffer[(m_ring->m_tail + m_position) % RING_BUFFER_SLOTS];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator& operator++()
+        {
+            ++m_position;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++m_position;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return m_position == other.m_position && m_ring == other.m_ring;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const RingBuffer* m_ring;
+        int m_position;  // 0 is the oldest message
+    };
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
     }
 
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    // Ids currently held; builds a map on every call, iterate the buffer
+    // instead to inspect it without allocating
     std::unordered_map<uint32_t, bool> getMessageMap() const
     {
-        return m_messageMap;
+        std::unordered_map<uint32_t, bool> map;
+        for (int i = 0; i < m_size; ++i)
+        {
+            map[m_buffer[(m_tail + i) % RING_BUFFER_SLOTS].id] = true;
+        }
+        return map;
     }
 
     uint32_t size() const
@@ -91,10 +226,28 @@ public:
         return m_size;
     }
 
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
 private:
-    T m_buffer[RING_BUFFER_SIZE];  // Array to store messages
+    // One spare slot past the capacity for prepare()
+    static const int RING_BUFFER_SLOTS = N + 1;
+
+    using Slot = typename IdIndex<N>::Slot;
+
+    // Drop the message at the tail; its id may already have been forgotten
+    // and stored again in a newer slot, which must stay indexed
+    void evictOldest()
+    {
+        m_index.erase(m_buffer[m_tail].id, static_cast<Slot>(m_tail));
+        m_tail = (m_tail + 1) % RING_BUFFER_SLOTS;
+    }
+
+    T m_buffer[RING_BUFFER_SLOTS];  // Array to store messages
     int m_head;  // Points to the next position to insert a new message
     int m_tail;  // Points to the oldest message
     int m_size;  // Current number of elements in the buffer
-    std::unordered_map<uint32_t, bool> m_messageMap;  // Hash table for fast lookup
+    IdIndex<N> m_index;  // id -> slot in m_buffer
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+// Bounds the computed retransmit timeout is clamped to, in ms
+#define RTO_MIN_MS 50
+#define RTO_MAX_MS 8000
+
+// Round trip time of one peer, smoothed from send-to-ACK samples as in
+// RFC 6298: SRTT moves 1/8 and RTTVAR 1/4 of the way towards each sample,
+// and the retransmit timeout is SRTT + 4 * RTTVAR. Both are kept in fixed
+// point (SRTT x8, RTTVAR x4), so a sample is a few adds and shifts.
+class RttEstimator
+{
+public:
+    void sample(uint32_t rtt)
+    {
+        if (!m_sampled)
+        {
+            // First measurement: SRTT = R, RTTVAR = R / 2
+            m_srtt8 = rtt << 3;
+            m_rttvar4 = rtt << 1;
+            m_sampled = true;
+            return;
+        }
+        int32_t error = static_cast<int32_t>(rtt) - static_cast<int32_t>(m_srtt8 >> 3);
+        m_srtt8 += error;
+        if (error < 0)
+        {
+            error = -error;
+        }
+        m_rttvar4 += error - static_cast<int32_t>(m_rttvar4 >> 2);
+    }
+
+    // Unclamped retransmit timeout; only meaningful once sampled
+    uint32_t rto() const
+    {
+        return (m_srtt8 >> 3) + m_rttvar4;
+    }
+
+    uint32_t srtt() const
+    {
+        return m_srtt8 >> 3;
+    }
+
+    uint32_t rttvar() const
+    {
+        return m_rttvar4 >> 2;
+    }
+
+    bool sampled() const
+    {
+        return m_sampled;
+    }
+
+    void reset()
+    {
+        m_srtt8 = 0;
+        m_rttvar4 = 0;
+        m_sampled = false;
+    }
+
+private:
+    uint32_t m_srtt8 = 0;
+    uint32_t m_rttvar4 = 0;
+    bool m_sampled = false;
+};
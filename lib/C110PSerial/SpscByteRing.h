@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Lock-free single producer / single consumer byte ring. One side (a UART
+// ISR or a reader thread) pushes received bytes, the protocol task pops
+// them in bulk with readFrame(); neither side blocks or takes a lock.
+//
+// Head and tail run freely and are masked on access, so the capacity must
+// be a power of two. The producer publishes bytes with a release store of
+// head and the consumer frees space with a release store of tail; each side
+// acquires the other's index before touching the data.
+class SpscByteRingBase
+{
+public:
+    // Producer: store up to `len` bytes, returns how many fit. For a
+    // producer that can wait and retry the rest, e.g. a reader thread
+    size_t tryPush(const uint8_t* data, size_t len)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        size_t space = m_capacity - (head - tail);
+        size_t count = len < space ? len : space;
+        copyIn(head, data, count);
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Producer: as tryPush(), but bytes that did not fit are given up and
+    // counted in dropped(). For a producer that cannot wait, e.g. an ISR
+    size_t push(const uint8_t* data, size_t len)
+    {
+        size_t count = tryPush(data, len);
+        if (count < len)
+        {
+            m_dropped.fetch_add(static_cast<uint32_t>(len - count), std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    // Producer: single byte, e.g. from a receive interrupt
+    bool push(uint8_t byte)
+    {
+        return push(&byte, 1) == 1;
+    }
+
+    // Consumer: move up to `max` bytes into `dst`, returns how many
+    size_t pop(uint8_t* dst, size_t max)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t used = head - tail;
+        size_t count = max < used ? max : used;
+        copyOut(tail, dst, count);
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: bytes waiting to be popped
+    size_t available() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    // Bytes the producer had to discard because the ring was full
+    uint32_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+protected:
+    SpscByteRingBase(uint8_t* storage, size_t capacity)
+        : m_data(storage), m_capacity(capacity), m_mask(capacity - 1)
+    {
+    }
+
+private:
+    // The span may wrap past the end of the storage
+    void copyIn(size_t head, const uint8_t* src, size_t count)
+    {
+        size_t offset = head & m_mask;
+        size_t first = count < m_capacity - offset ? count : m_capacity - offset;
+        memcpy(&m_data[offset], src, first);
+        memcpy(m_data, src + first, count - first);
+    }
+
+    void copyOut(size_t tail, uint8_t* dst, size_t count) const
+    {
+        size_t offset = tail & m_mask;
+        size_t first = count < m_capacity - offset ? count : m_capacity - offset;
+        memcpy(dst, &m_data[offset], first);
+        memcpy(dst + first, m_data, count - first);
+    }
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    uint8_t* m_data;
+    size_t m_capacity;
+    size_t m_mask;
+    // Each index on its own cache line so the two sides do not false share
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};  // Written by the producer
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};  // Written by the consumer
+    std::atomic<uint32_t> m_dropped{0};
+};
+
+template<size_t Capacity>
+class SpscByteRing : public SpscByteRingBase
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscByteRing()
+        : SpscByteRingBase(m_storage, Capacity)
+    {
+    }
+
+    SpscByteRing(const SpscByteRing&) = delete;
+    SpscByteRing& operator=(const SpscByteRing&) = delete;
+
+private:
+    uint8_t m_storage[Capacity];
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+// Trace levels: anything above C110P_TRACE_LEVEL compiles out entirely,
+// including the formatting of its arguments
+#define C110P_TRACE_LEVEL_NONE 0
+#define C110P_TRACE_LEVEL_ERROR 1
+#define C110P_TRACE_LEVEL_WARN 2
+#define C110P_TRACE_LEVEL_INFO 3
+#define C110P_TRACE_LEVEL_DEBUG 4
+
+#ifndef C110P_TRACE_LEVEL
+#define C110P_TRACE_LEVEL C110P_TRACE_LEVEL_WARN
+#endif
+
+// Define C110P_TRACE_RING to record compact binary events in memory
+#ifndef C110P_TRACE_RING_SIZE
+#define C110P_TRACE_RING_SIZE 64
+#endif
+
+#define C110P_TRACE_NOOP() do {} while (0)
+#define C110P_TRACE_PRINT(tag, expr) do { std::cout << tag << expr << std::endl; } while (0)
+
+#if C110P_TRACE_LEVEL >= C110P_TRACE_LEVEL_ERROR
+#define C110P_TRACE_ERROR(expr) C110P_TRACE_PRINT("[ERROR] ", expr)
+#else
+#define C110P_TRACE_ERROR(expr) C110P_TRACE_NOOP()
+#endif
+
+#if C110P_TRACE_LEVEL >= C110P_TRACE_LEVEL_WARN
+#define C110P_TRACE_WARN(expr) C110P_TRACE_PRINT("[WARN] ", expr)
+#else
+#define C110P_TRACE_WARN(expr) C110P_TRACE_NOOP()
+#endif
+
+#if C110P_TRACE_LEVEL >= C110P_TRACE_LEVEL_INFO
+#define C110P_TRACE_INFO(expr) C110P_TRACE_PRINT("[INFO] ", expr)
+#else
+#define C110P_TRACE_INFO(expr) C110P_TRACE_NOOP()
+#endif
+
+#if C110P_TRACE_LEVEL >= C110P_TRACE_LEVEL_DEBUG
+#define C110P_TRACE_DEBUG(expr) C110P_TRACE_PRINT("[DEBUG] ", expr)
+#else
+#define C110P_TRACE_DEBUG(expr) C110P_TRACE_NOOP()
+#endif
+
+#ifdef C110P_TRACE_RING
+#define C110P_TRACE_EVENT(event, msgId, timestamp) c110pTraceRing().record((event), (msgId), (timestamp))
+#else
+#define C110P_TRACE_EVENT(event, msgId, timestamp) C110P_TRACE_NOOP()
+#endif
+
+enum class TraceEvent : uint8_t {
+    FrameReceived,
+    FrameInvalidLength,
+    FrameCrcMismatch,
+    FrameOverflow,
+    DecodeFailed,
+    DuplicateReceived,
+    Sent,
+    EncodeFailed,
+    Retry,
+    RetryExhausted,
+    AckReceived,
+    NackReceived,
+    SendBlocked,
+    Superseded
+};
+
+struct TraceRecord {
+    uint32_t timestamp;
+    uint32_t msgId;
+    TraceEvent event;
+};
+
+// Fixed-size ring of trace records; the oldest record is overwritten once full
+template<size_t N>
+class TraceRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "TraceRing size must be a power of two");
+
+public:
+    void record(TraceEvent event, uint32_t msgId, uint32_t timestamp)
+    {
+        TraceRecord& slot = m_records[m_next & (N - 1)];
+        slot.timestamp = timestamp;
+        slot.msgId = msgId;
+        slot.event = event;
+        ++m_next;
+    }
+
+    void clear()
+    {
+        m_next = 0;
+    }
+
+    size_t size() const
+    {
+        return m_next < N ? m_next : N;
+    }
+
+    // Records in order, index 0 being the oldest still held
+    const TraceRecord& at(size_t index) const
+    {
+        size_t first = m_next < N ? 0 : m_next - N;
+        return m_records[(first + index) & (N - 1)];
+    }
+
+    void dump(std::ostream& os) const
+    {
+        for (size_t i = 0; i < size(); ++i)
+        {
+            const TraceRecord& r = at(i);
+            os << r.timestamp << " event=" << static_cast<int>(r.event) << " id=" << r.msgId << std::endl;
+        }
+    }
+
+private:
+    TraceRecord m_records[N] = {};
+    size_t m_next = 0;
+};
+
+inline TraceRing<C110P_TRACE_RING_SIZE>& c110pTraceRing()
+{
+    static TraceRing<C110P_TRACE_RING_SIZE> ring;
+    return ring;
+}
+
+// Stream helper to hex dump a byte span inside a trace expression
+struct TraceHex {
+    const uint8_t* data;
+    size_t len;
+
+    TraceHex(const uint8_t* d, size_t l) : data(d), len(l) {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const TraceHex& hex)
+{
+    std::ios_base::fmtflags flags = os.flags();
+    char fill = os.fill();
+    for (size_t i = 0; i < hex.len; ++i)
+    {
+        if (i > 0)
+        {
+            os << " ";
+        }
+        os << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << static_cast<int>(hex.data[i]);
+    }
+    os.flags(flags);
+    os.fill(fill);
+    return os;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Commands held per send class
+#define TX_QUEUE_DEPTH 8
+
+// Outgoing commands waiting for room on the link, one fixed queue per
+// class. Classes of weight 0 are served in strict priority, lowest number
+// first, before any other; the rest share what is left by deficit round
+// robin, so a class of weight w sends up to w commands per round while
+// the others have some waiting. Nothing is allocated.
+template<typename T, size_t Classes, size_t Depth = TX_QUEUE_DEPTH>
+class TxScheduler
+{
+    static_assert(Classes > 0, "Classes must be at least 1");
+    static_assert(Depth > 0, "Depth must be at least 1");
+
+public:
+    // Returned by select() when nothing is waiting
+    static constexpr size_t NONE = Classes;
+
+    TxScheduler()
+    {
+        for (size_t c = 0; c < Classes; ++c)
+        {
+            m_weights[c] = 1;
+        }
+        clear();
+    }
+
+    // 0 puts `cls` in strict priority
+    void setWeight(size_t cls, uint8_t weight)
+    {
+        if (cls < Classes)
+        {
+            m_weights[cls] = weight;
+        }
+    }
+
+    uint8_t weight(size_t cls) const
+    {
+        return m_weights[cls];
+    }
+
+    // Queue `item` behind the others of `cls`; false if that queue is full
+    bool push(size_t cls, const T& item)
+    {
+        Queue& queue = m_queues[cls];
+        if (queue.count >= Depth)
+        {
+            return false;
+        }
+        queue.items[(queue.head + queue.count) % Depth] = item;
+        queue.count++;
+        m_size++;
+        return true;
+    }
+
+    // The class to send from next, or NONE
+    size_t select()
+    {
+        for (size_t c = 0; c < Classes; ++c)
+        {
+            if (m_weights[c] == 0 && m_queues[c].count > 0)
+            {
+                return c;
+            }
+        }
+        // The current class keeps its turn while it has credit and work;
+        // each class passed over gets a fresh round's credit
+        for (size_t visited = 0; visited <= Classes; ++visited)
+        {
+            if (m_weights[m_current] > 0 && m_credit > 0 && m_queues[m_current].count > 0)
+            {
+                return m_current;
+            }
+            m_current = (m_current + 1) % Classes;
+            m_credit = m_weights[m_current];
+        }
+        return NONE;
+    }
+
+    // Oldest item of `cls`; only valid when it has one
+    T& front(size_t cls)
+    {
+        Queue& queue = m_queues[cls];
+        return queue.items[queue.head];
+    }
+
+    // Drop the oldest item of `cls`, once sent, charging it to its turn
+    void pop(size_t cls)
+    {
+        Queue& queue = m_queues[cls];
+        queue.head = (queue.head + 1) % Depth;
+        queue.count--;
+        m_size--;
+        if (cls == m_current && m_credit > 0)
+        {
+            m_credit--;
+        }
+    }
+
+    // First item of `cls`, oldest first, for which `match(item)` holds
+    template<typename F>
+    T* find(size_t cls, F&& match)
+    {
+        Queue& queue = m_queues[cls];
+        for (size_t i = 0; i < queue.count; ++i)
+        {
+            T& item = queue.items[(queue.head + i) % Depth];
+            if (match(item))
+            {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t size(size_t cls) const
+    {
+        return m_queues[cls].count;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        for (Queue& queue : m_queues)
+        {
+            queue.head = 0;
+            queue.count = 0;
+        }
+        m_size = 0;
+        m_current = 0;
+        m_credit = m_weights[0];
+    }
+
+private:
+    struct Queue {
+        T items[Depth];
+        size_t head;
+        size_t count;
+    };
+
+    Queue m_queues[Classes];
+    uint8_t m_weights[Classes];
+    size_t m_size;
+    size_t m_current;   // Weighted class whose turn it is
+    uint8_t m_credit;   // Commands it may still send this turn
+};
+
+// Depth 0 compiles the queues out: nothing is held and nothing is waiting
+template<typename T, size_t Classes>
+class TxScheduler<T, Classes, 0>
+{
+public:
+    static constexpr size_t NONE = Classes;
+
+    void setWeight(size_t, uint8_t) {}
+
+    bool push(size_t, const T&)
+    {
+        return false;
+    }
+
+    size_t select()
+    {
+        return NONE;
+    }
+
+    template<typename F>
+    T* find(size_t, F&&)
+    {
+        return nullptr;
+    }
+
+    size_t size(size_t) const
+    {
+        return 0;
+    }
+
+    size_t size() const
+    {
+        return 0;
+    }
+
+    bool empty() const
+    {
+        return true;
+    }
+
+    void clear() {}
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Unsigned LEB128 / protobuf varint: 7 bits per byte, least significant
+// group first, high bit set on every byte but the last
+class Varint {
+public:
+    static const uint8_t CONTINUATION = 0x80;
+    static const size_t MAX_BYTES = 5; // uint32_t
+
+    // Bytes needed to encode `value`
+    static constexpr size_t encodedSize(uint32_t value)
+    {
+        return value < 0x80 ? 1 : 1 + encodedSize(value >> 7);
+    }
+
+    // Encode `value` into `dst`, which must hold encodedSize(value) bytes.
+    // Returns the number of bytes written.
+    static size_t encode(uint32_t value, uint8_t* dst)
+    {
+        size_t out = 0;
+        while (value >= CONTINUATION)
+        {
+            dst[out++] = static_cast<uint8_t>(value) | CONTINUATION;
+            value >>= 7;
+        }
+        dst[out++] = static_cast<uint8_t>(value);
+        return out;
+    }
+};
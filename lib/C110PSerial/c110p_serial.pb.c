@@ -12,6 +12,9 @@ PB_BIND(C110PCommand, C110PCommand, AUTO)
 PB_BIND(AckCommand, AckCommand, AUTO)
 
 
+PB_BIND(AckBatchCommand, AckBatchCommand, AUTO)
+
+
 PB_BIND(LedCommand, LedCommand, AUTO)
 
 
@@ -26,3 +29,5 @@ PB_BIND(SoundCommand, SoundCommand, AUTO)
 
 
 
+
+
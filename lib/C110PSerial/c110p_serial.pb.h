@@ -23,12 +23,24 @@ typedef enum _C110PActuator {
     C110PActuator_BODY_NECK = 1
 } C110PActuator;
 
+/* Delivery class of a command */
+typedef enum _C110PQos {
+    C110PQos_QOS_RELIABLE = 0, /* ACKed, and retried until it is */
+    C110PQos_QOS_BEST_EFFORT = 1 /* Neither ACKed nor retried, e.g. setpoint streams */
+} C110PQos;
+
 /* Struct definitions */
 typedef struct _AckCommand {
     bool acknowledged;
     char reason[16]; /* Limit string to 16 bytes; */
 } AckCommand;
 
+/* ACK of several messages in one frame: the command id and each id + offset */
+typedef struct _AckBatchCommand {
+    pb_size_t offsets_count;
+    int32_t offsets[7];
+} AckBatchCommand;
+
 typedef struct _LedCommand {
     uint32_t start;
     uint32_t end;
@@ -58,7 +70,11 @@ typedef struct _C110PCommand {
         LedCommand led;
         MoveCommand move;
         SoundCommand sound;
+        AckBatchCommand ack_batch;
     } data;
+    /* Id of a received message, ACKed along with this one; 0 for none */
+    uint32_t piggyback_ack;
+    C110PQos qos;
 } C110PCommand;
 
 
@@ -75,8 +91,14 @@ extern "C" {
 #define _C110PActuator_MAX C110PActuator_BODY_NECK
 #define _C110PActuator_ARRAYSIZE ((C110PActuator)(C110PActuator_BODY_NECK+1))
 
+#define _C110PQos_MIN C110PQos_QOS_RELIABLE
+#define _C110PQos_MAX C110PQos_QOS_BEST_EFFORT
+#define _C110PQos_ARRAYSIZE ((C110PQos)(C110PQos_QOS_BEST_EFFORT+1))
+
 #define C110PCommand_source_ENUMTYPE C110PRegion
 #define C110PCommand_target_ENUMTYPE C110PRegion
+#define C110PCommand_qos_ENUMTYPE C110PQos
+
 
 
 
@@ -85,13 +107,15 @@ extern "C" {
 
 
 /* Initializer values for message structs */
-#define C110PCommand_init_default                {0, _C110PRegion_MIN, _C110PRegion_MIN, 0, {AckCommand_init_default}}
+#define C110PCommand_init_default                {0, _C110PRegion_MIN, _C110PRegion_MIN, 0, {AckCommand_init_default}, 0, _C110PQos_MIN}
 #define AckCommand_init_default                  {0, ""}
+#define AckBatchCommand_init_default             {0, {0, 0, 0, 0, 0, 0, 0}}
 #define LedCommand_init_default                  {0, 0, 0}
 #define MoveCommand_init_default                 {_C110PActuator_MIN, 0, 0, 0}
 #define SoundCommand_init_default                {0, 0, 0}
-#define C110PCommand_init_zero                   {0, _C110PRegion_MIN, _C110PRegion_MIN, 0, {AckCommand_init_zero}}
+#define C110PCommand_init_zero                   {0, _C110PRegion_MIN, _C110PRegion_MIN, 0, {AckCommand_init_zero}, 0, _C110PQos_MIN}
 #define AckCommand_init_zero                     {0, ""}
+#define AckBatchCommand_init_zero                {0, {0, 0, 0, 0, 0, 0, 0}}
 #define LedCommand_init_zero                     {0, 0, 0}
 #define MoveCommand_init_zero                    {_C110PActuator_MIN, 0, 0, 0}
 #define SoundCommand_init_zero                   {0, 0, 0}
@@ -99,6 +123,7 @@ extern "C" {
 /* Field tags (for use in manual encoding/decoding) */
 #define AckCommand_acknowledged_tag              1
 #define AckCommand_reason_tag                    2
+#define AckBatchCommand_offsets_tag              1
 #define LedCommand_start_tag                     1
 #define LedCommand_end_tag                       2
 #define LedCommand_duration_tag                  3
@@ -116,6 +141,9 @@ extern "C" {
 #define C110PCommand_led_tag                     5
 #define C110PCommand_move_tag                    6
 #define C110PCommand_sound_tag                   7
+#define C110PCommand_ack_batch_tag               8
+#define C110PCommand_piggyback_ack_tag           9
+#define C110PCommand_qos_tag                     10
 
 /* Struct field encoding specification for nanopb */
 #define C110PCommand_FIELDLIST(X, a) \
@@ -125,13 +153,17 @@ X(a, STATIC,   SINGULAR, UENUM,    target,            3) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (data,ack,data.ack),   4) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (data,led,data.led),   5) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (data,move,data.move),   6) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (data,sound,data.sound),   7)
+X(a, STATIC,   ONEOF,    MESSAGE,  (data,sound,data.sound),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (data,ack_batch,data.ack_batch),   8) \
+X(a, STATIC,   SINGULAR, UINT32,   piggyback_ack,     9) \
+X(a, STATIC,   SINGULAR, UENUM,    qos,              10)
 #define C110PCommand_CALLBACK NULL
 #define C110PCommand_DEFAULT NULL
 #define C110PCommand_data_ack_MSGTYPE AckCommand
 #define C110PCommand_data_led_MSGTYPE LedCommand
 #define C110PCommand_data_move_MSGTYPE MoveCommand
 #define C110PCommand_data_sound_MSGTYPE SoundCommand
+#define C110PCommand_data_ack_batch_MSGTYPE AckBatchCommand
 
 #define AckCommand_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, BOOL,     acknowledged,      1) \
@@ -139,6 +171,11 @@ X(a, STATIC,   SINGULAR, STRING,   reason,            2)
 #define AckCommand_CALLBACK NULL
 #define AckCommand_DEFAULT NULL
 
+#define AckBatchCommand_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, SINT32,   offsets,           1)
+#define AckBatchCommand_CALLBACK NULL
+#define AckBatchCommand_DEFAULT NULL
+
 #define LedCommand_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   start,             1) \
 X(a, STATIC,   SINGULAR, UINT32,   end,               2) \
@@ -163,6 +200,7 @@ X(a, STATIC,   SINGULAR, BOOL,     syncToLeds,        3)
 
 extern const pb_msgdesc_t C110PCommand_msg;
 extern const pb_msgdesc_t AckCommand_msg;
+extern const pb_msgdesc_t AckBatchCommand_msg;
 extern const pb_msgdesc_t LedCommand_msg;
 extern const pb_msgdesc_t MoveCommand_msg;
 extern const pb_msgdesc_t SoundCommand_msg;
@@ -170,13 +208,15 @@ extern const pb_msgdesc_t SoundCommand_msg;
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define C110PCommand_fields &C110PCommand_msg
 #define AckCommand_fields &AckCommand_msg
+#define AckBatchCommand_fields &AckBatchCommand_msg
 #define LedCommand_fields &LedCommand_msg
 #define MoveCommand_fields &MoveCommand_msg
 #define SoundCommand_fields &SoundCommand_msg
 
 /* Maximum encoded size of messages (where known) */
+#define AckBatchCommand_size                     37
 #define AckCommand_size                          19
-#define C110PCommand_size                        32
+#define C110PCommand_size                        57
 #define C110P_SERIAL_PB_H_MAX_SIZE               C110PCommand_size
 #define LedCommand_size                          18
 #define MoveCommand_size                         20
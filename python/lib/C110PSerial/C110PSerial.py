@@ -1,5 +1,5 @@
 from .ProtoFrame import ProtoFrame
-from .proto_encode import encode_command
+from .proto_encode import encode_command, encode_varint
 from .proto_decode import decode_command
 from .Logger import logger
 
@@ -12,35 +12,46 @@ C110PRegion_REGION_DOME = 4
 C110PActuator_UNSPECIFIED = 0
 C110PActuator_BODY_NECK = 1
 
+C110PQos_QOS_RELIABLE = 0
+C110PQos_QOS_BEST_EFFORT = 1
+
 class C110PSerial(ProtoFrame):
-    def __init__(self, stream, identifier=C110PRegion_REGION_UNSPECIFIED, timeout=1000):
-        super().__init__(stream, identifier, timeout)
+    def __init__(self, stream, identifier=C110PRegion_REGION_UNSPECIFIED, timeout=1000, maxSize=ProtoFrame.MAX_SIZE,
+                 integrity=ProtoFrame.INTEGRITY_CRC8):
+        super().__init__(stream, identifier, timeout, maxSize=maxSize, integrity=integrity)
 
     def send(self, msg) -> bool:
         err, buffer = encode_command(msg)
-        if len(buffer) > self.MAX_SIZE:
+        if len(buffer) > self.maxPayloadSize():
             logger.error(f"Message too large: {len(buffer)}")
             return False
         if err:
             logger.error(f"Error encoding message: {err}")
             return False
 
-        crc = self.crc8.calculate(buffer)
-        logger.debug("Sending data: [{}] LEN: {} CRC: {:02X}".format(
+        crc = self.crc.to_bytes(self.crc.calculate(buffer))
+        logger.debug("Sending data: [{}] LEN: {} CRC: {}".format(
             ' '.join('{:02X}'.format(b) for b in buffer),
             len(buffer),
-            crc
+            crc.hex().upper()
         ))
 
+        if self.m_frameFormat == self.FRAME_FORMAT_VARINT:
+            length = bytes(encode_varint(len(buffer)))
+        else:
+            length = bytes([len(buffer)])
+
         if not any((self.m_stream.write(bytes([self.START_BYTE])),
-            self.m_stream.write(bytes([len(buffer)])),
+            self.m_stream.write(length),
             self.m_stream.write(buffer),
-            self.m_stream.write(bytes([crc])))
+            self.m_stream.write(crc))
         ):
             logger.error("Write failed")
             return False
         
-        self.trackMessage(msg)
+        # Best-effort commands are neither ACKed nor retried
+        if msg.get("qos") != C110PQos_QOS_BEST_EFFORT:
+            self.trackMessage(msg)
         return True
 
     def processQueue(self):
@@ -28,3 +28,71 @@ class CRC8:
         for b in data:
             crc = self._table[crc ^ b]
         return crc ^ self.XOROUT
+
+    # Check bytes as sent after the payload
+    SIZE = 1
+
+    def to_bytes(self, crc):
+        return bytes([crc])
+
+
+class CRC16:
+    # CRC-16/CCITT-FALSE, same as Crc16Ccitt in CRC.h
+    POLY = 0x1021
+    INIT = 0xFFFF
+    XOROUT = 0x0000
+    SIZE = 2
+
+    def __init__(self):
+        self._table = [self._calculate_byte(i) for i in range(256)]
+
+    @staticmethod
+    def _calculate_byte(byte):
+        crc = byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ CRC16.POLY) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+        return crc
+
+    def calculate(self, data):
+        crc = self.INIT
+        for b in data:
+            crc = ((crc << 8) & 0xFFFF) ^ self._table[(crc >> 8) ^ b]
+        return crc ^ self.XOROUT
+
+    def to_bytes(self, crc):
+        # Least significant byte first
+        return bytes([crc & 0xFF, crc >> 8])
+
+
+class CRC32C:
+    # CRC-32C (Castagnoli), same as Crc32C in CRC.h; reflected
+    POLY = 0x82F63B78
+    INIT = 0xFFFFFFFF
+    XOROUT = 0xFFFFFFFF
+    SIZE = 4
+
+    def __init__(self):
+        self._table = [self._calculate_byte(i) for i in range(256)]
+
+    @staticmethod
+    def _calculate_byte(byte):
+        crc = byte
+        for _ in range(8):
+            if crc & 1:
+                crc = (crc >> 1) ^ CRC32C.POLY
+            else:
+                crc >>= 1
+        return crc
+
+    def calculate(self, data):
+        crc = self.INIT
+        for b in data:
+            crc = (crc >> 8) ^ self._table[(crc ^ b) & 0xFF]
+        return crc ^ self.XOROUT
+
+    def to_bytes(self, crc):
+        # Least significant byte first
+        return bytes([crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, crc >> 24])
@@ -0,0 +1,58 @@
+class DedupWindow:
+    """Message ids already seen from one peer, as in DedupWindow.h: the
+    highest id plus a bitmap of the ids just below it. Ids compare in serial
+    number arithmetic, so the 32 bit ids may wrap. An id below the window
+    comes from a peer that restarted its clock; the window starts over."""
+    # Ids are millisecond timestamps: 8160 ms covers the default 1 s timeout
+    # doubled over 3 retries
+    DEDUP_WINDOW_BITS = 8192
+    # Check results
+    FRESH = 0
+    DUPLICATE = 1
+
+    def __init__(self, bits=DEDUP_WINDOW_BITS):
+        # The word holding the highest id is shared with ids a whole bitmap
+        # below it, so the window covers bits - 32 ids
+        self.WINDOW = bits - 32
+        self._bits = bits
+        self.reset()
+
+    def reset(self):
+        self._bitmap = 0
+        self._highest = 0
+        self._started = False
+
+    def highest(self):
+        return self._highest
+
+    def empty(self):
+        return not self._started
+
+    def check(self, id):
+        """Classify `id` and record it if it is fresh"""
+        if not self._started:
+            self._restart(id)
+            return self.FRESH
+        ahead = (id - self._highest) & 0xFFFFFFFF
+        if 0 < ahead < 0x80000000:
+            # Bit i stands for id highest - i
+            self._bitmap = ((self._bitmap << ahead) | 1) & ((1 << self.WINDOW) - 1) if ahead < self.WINDOW else 1
+            self._highest = id
+            return self.FRESH
+        behind = (self._highest - id) & 0xFFFFFFFF
+        if behind >= self.WINDOW:
+            self._restart(id)
+            return self.FRESH
+        if self._bitmap >> behind & 1:
+            return self.DUPLICATE
+        self._bitmap |= 1 << behind
+        return self.FRESH
+
+    def contains(self, id):
+        behind = (self._highest - id) & 0xFFFFFFFF
+        return self._started and behind < self.WINDOW and bool(self._bitmap >> behind & 1)
+
+    def _restart(self, id):
+        self._started = True
+        self._highest = id & 0xFFFFFFFF
+        self._bitmap = 1
@@ -1,5 +1,6 @@
 import time
-from .CRC8 import CRC8
+from .CRC8 import CRC8, CRC16, CRC32C
+from .DedupWindow import DedupWindow
 from .RingBuffer import RingBuffer
 from .proto_encode import encode_command
 from .proto_decode import decode_command
@@ -10,24 +11,52 @@ class ProtoFrame:
     MAX_SIZE = 128
     BUFFER_DATA_MAX_SIZE = 128
     BUFFER_MESSAGE_MAX_SIZE = 256
+    VARINT_MAX_BYTES = 5
+    # Sending regions, each with its own duplicate window
+    REGION_COUNT = 5
 
-    def __init__(self, stream, identifier=0, timeout=1000, maxRetries=3):
+    # Wire format of a frame, same values as ProtoFrameFormat in C++:
+    #   START_LENGTH: | START_BYTE | len | data | crc |
+    #   VARINT:       | START_BYTE | varint(len) | data | crc |
+    FRAME_FORMAT_START_LENGTH = 0
+    FRAME_FORMAT_VARINT = 2
+
+    # Frame check carried as `crc`, least significant byte first, same values
+    # as ProtoFrameIntegrity in C++. Both ends of a link must agree.
+    INTEGRITY_CRC8 = 0
+    INTEGRITY_CRC16 = 1
+    INTEGRITY_CRC32C = 2
+
+    # Delivery class of a command, as C110PQos
+    QOS_BEST_EFFORT = 1
+
+    def __init__(self, stream, identifier=0, timeout=1000, maxRetries=3, maxSize=MAX_SIZE, integrity=INTEGRITY_CRC8):
         self.m_regionId = identifier
         self.m_stream = stream
         self.m_sentMessageBuffer = RingBuffer()
-        self.m_receivedMessageBuffer = RingBuffer()
+        # Received messages are not kept: duplicates are recognised by id,
+        # per sending region, and only the latest message is held
+        self.m_receivedIds = [DedupWindow() for _ in range(self.REGION_COUNT)]
+        self.m_lastReceived = None
+        self.m_receivedCount = 0
         self.m_messageTimeout = timeout
         self.m_maxRetries = maxRetries
         self.m_messageInfoMap = {}
-        self.m_inputBuffer = bytearray(self.BUFFER_MESSAGE_MAX_SIZE)
-        self.m_inputIndex = 0
-        self.m_inputLength = 0
-        self.m_inputCrc = 0
+        self.MAX_SIZE = maxSize
+        self.m_inputBuffer = bytearray(max(self.BUFFER_MESSAGE_MAX_SIZE, maxSize))
+        self.m_frameFormat = self.FRAME_FORMAT_START_LENGTH
+        self.resetParser()
         self.m_timestampProvider = lambda: int(time.time())
         self.m_LedCallback = lambda msg: None
         self.m_SoundCallback = lambda msg: None
         self.m_MoveCallback = lambda msg: None
         self.crc8 = CRC8()
+        self.m_integrity = integrity
+        self.crc = {
+            self.INTEGRITY_CRC8: lambda: self.crc8,
+            self.INTEGRITY_CRC16: CRC16,
+            self.INTEGRITY_CRC32C: CRC32C,
+        }[integrity]()
 
         if hasattr(self.m_stream, 'any'):
             # MicroPython
@@ -43,11 +72,29 @@ class ProtoFrame:
 
     def reset(self):
         self.m_sentMessageBuffer.reset()
-        self.m_receivedMessageBuffer.reset()
+        for ids in self.m_receivedIds:
+            ids.reset()
+        self.m_lastReceived = None
+        self.m_receivedCount = 0
         self.m_messageInfoMap = {}
+        self.resetParser()
+
+    def resetParser(self):
         self.m_inputIndex = 0
         self.m_inputLength = 0
-        self.m_inputCrc = 0
+        self.m_inputLengthBytes = 0
+        self.m_inputCrc = bytearray()
+
+    def setFrameFormat(self, frameFormat):
+        # Both ends of a link must use the same format
+        self.m_frameFormat = frameFormat
+        self.resetParser()
+
+    def maxPayloadSize(self):
+        # StartLength frames carry a one byte length
+        if self.m_frameFormat == self.FRAME_FORMAT_START_LENGTH:
+            return min(self.MAX_SIZE - 1, 0xFF)
+        return self.MAX_SIZE - 1
 
     def setTimestampProvider(self, provider):
         self.m_timestampProvider = provider
@@ -80,8 +127,15 @@ class ProtoFrame:
             self.m_messageInfoMap[msg["id"]]["lastProcessedTimestamp"] = self.getSafeTimestamp()
             self.m_messageInfoMap[msg["id"]]["retryCount"] += 1
 
+    def receivedIds(self, source):
+        # Unknown regions share the REGION_UNSPECIFIED window
+        return self.m_receivedIds[source if 0 <= source < self.REGION_COUNT else 0]
+
     def receive(self, msg):
-        self.m_receivedMessageBuffer.add(msg)
+        if self.receivedIds(msg.get("source", 0)).check(msg["id"]) != DedupWindow.FRESH:
+            return False
+        self.m_lastReceived = msg
+        self.m_receivedCount += 1
         return True
 
     def readFrame(self):
@@ -100,32 +154,43 @@ class ProtoFrame:
                 self.m_inputIndex = 1
                 continue
             elif self.m_inputIndex == 1:
-                self.m_inputLength = c
-                if self.m_inputLength > self.MAX_SIZE - 1:
-                    self.m_inputIndex = 0
-                    self.m_inputLength = 0
-                    self.m_inputCrc = 0
+                valid = True
+                if self.m_frameFormat == self.FRAME_FORMAT_VARINT:
+                    # The length may span several bytes, and several reads
+                    self.m_inputLength |= (c & 0x7F) << (7 * self.m_inputLengthBytes)
+                    self.m_inputLengthBytes += 1
+                    if c & 0x80:
+                        if self.m_inputLengthBytes < self.VARINT_MAX_BYTES:
+                            continue
+                        valid = False
+                    elif c == 0 and self.m_inputLengthBytes > 1:
+                        # Overlong encoding, never produced by a sender
+                        valid = False
+                else:
+                    self.m_inputLength = c
+                if not valid or self.m_inputLength > self.MAX_SIZE - 1:
                     logger.error(f"Invalid length: {self.m_inputLength}")
+                    self.resetParser()
                     return False
                 else:
                     self.m_inputIndex += 1
                 continue
-            elif self.m_inputIndex == self.m_inputLength + 2:
-                self.m_inputCrc = c
-                if self.crc8.calculate(self.m_inputBuffer[:self.m_inputLength]) == self.m_inputCrc:
+            elif self.m_inputIndex >= self.m_inputLength + 2:
+                self.m_inputCrc.append(c)
+                self.m_inputIndex += 1
+                if len(self.m_inputCrc) < self.crc.SIZE:
+                    continue
+                expected = self.crc.to_bytes(self.crc.calculate(self.m_inputBuffer[:self.m_inputLength]))
+                if expected == bytes(self.m_inputCrc):
                     self.receiveMessage(self.m_inputBuffer[:self.m_inputLength])
-                    self.m_inputIndex = 0
-                    self.m_inputLength = 0
-                    self.m_inputCrc = 0
+                    self.resetParser()
                     return True
                 else:
-                    self.m_inputIndex = 0
-                    self.m_inputLength = 0
-                    self.m_inputCrc = 0
-                    logger.error("Invalid CRC: {m_inputCrc}")
+                    self.resetParser()
+                    logger.error(f"Invalid CRC: {bytes(self.m_inputCrc).hex()}")
                     return False
             elif self.m_inputIndex > 1:
-                if self.m_inputIndex < self.BUFFER_MESSAGE_MAX_SIZE - 1:
+                if self.m_inputIndex - 2 < len(self.m_inputBuffer):
                     self.m_inputBuffer[self.m_inputIndex - 2] = c
                     self.m_inputIndex += 1
                 else:
@@ -138,7 +203,8 @@ class ProtoFrame:
         return len(self.m_sentMessageBuffer)
 
     def getReceivedMessageBufferSize(self):
-        return len(self.m_receivedMessageBuffer)
+        # Messages accepted since the last reset()
+        return self.m_receivedCount
 
     def getUnacknowledgedMessagesSize(self):
         return len(self.m_messageInfoMap)
@@ -150,7 +216,7 @@ class ProtoFrame:
         return self.m_sentMessageBuffer.getCurrentValue()
 
     def getLastReceivedMessage(self):
-        return self.m_receivedMessageBuffer.getCurrentValue()
+        return self.m_lastReceived
 
     def handleAck(self, timestamp):
         self.m_messageInfoMap.pop(timestamp, None)
@@ -200,11 +266,26 @@ class ProtoFrame:
             if msg["id"] != 0:
                 self.sendNack(msg["id"], "Invalid message")
             return
-        if self.m_receivedMessageBuffer.contains(msg["id"]):
-            self.sendAck(msg['id'])
+        # An ACK carried by a command holds whether or not the command is new
+        if msg.get('piggyback_ack'):
+            self.handleAck(msg['piggyback_ack'])
+        # An ACK carries the id of the acknowledged message, from our own
+        # clock, so it stays out of the sender's window
+        is_ack = 'ack' in msg or 'ack_batch' in msg
+        if is_ack:
+            seen = DedupWindow.FRESH
+        else:
+            seen = self.receivedIds(msg.get("source", 0)).check(msg["id"])
+        wants_ack = not is_ack and msg.get('qos') != self.QOS_BEST_EFFORT
+        if seen == DedupWindow.DUPLICATE:
+            if wants_ack:
+                self.sendAck(msg['id'])
         else:
-            self.receive(msg)
-            self.sendAck(msg['id'])
+            self.m_lastReceived = msg
+            self.m_receivedCount += 1
+            # ACKs are not acknowledged themselves, nor best-effort commands
+            if wants_ack:
+                self.sendAck(msg['id'])
             self.processCallback(msg)
 
     def processCallback(self, message):
@@ -213,6 +294,11 @@ class ProtoFrame:
                 self.handleAck(message['id'])
             else:
                 self.handleNack(message['id'])
+        elif 'ack_batch' in message:
+            # Every covered message is cleared in this one pass
+            self.handleAck(message['id'])
+            for offset in message['ack_batch']['offsets']:
+                self.handleAck((message['id'] + offset) & 0xFFFFFFFF)
         elif 'led' in message and self.m_LedCallback:
             self.m_LedCallback(message['led'])
         elif 'move' in message and self.m_MoveCallback:
@@ -1,7 +1,8 @@
-from .CRC8 import CRC8
+from .CRC8 import CRC8, CRC16, CRC32C
 from .proto_decode import decode_command
 from .proto_encode import encode_command
 from .ProtoFrame import ProtoFrame
 from .C110PSerial import C110PSerial
 from .RingBuffer import RingBuffer
+from .DedupWindow import DedupWindow
 
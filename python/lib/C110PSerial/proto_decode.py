@@ -8,6 +8,9 @@ FIELD_ACK = 4
 FIELD_LED = 5
 FIELD_MOVE = 6
 FIELD_SOUND = 7
+FIELD_ACK_BATCH = 8
+FIELD_PIGGYBACK_ACK = 9
+FIELD_QOS = 10
 
 
 def parse_varint(stream):
@@ -53,6 +56,27 @@ def parse_ack(data):
     return ack
 
 
+def parse_ack_batch(data):
+    s = io.BytesIO(data)
+    batch = {
+        "offsets": []
+    }
+    while s.tell() < len(data):
+        field, wire = read_key(s)
+        if field == 1 and wire == 2:  # offsets, packed
+            packed = read_length_delimited(s)
+            p = io.BytesIO(packed)
+            while p.tell() < len(packed):
+                batch['offsets'].append(zigzag_decode(parse_varint(p)))
+        elif field == 1:
+            batch['offsets'].append(zigzag_decode(parse_varint(s)))
+    return batch
+
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
 def parse_led(data):
     s = io.BytesIO(data)
     led = {
@@ -138,6 +162,13 @@ def decode_command(buf):
         elif field == FIELD_SOUND:
             data = read_length_delimited(s)
             result['sound'] = parse_sound(data)
+        elif field == FIELD_ACK_BATCH:
+            data = read_length_delimited(s)
+            result['ack_batch'] = parse_ack_batch(data)
+        elif field == FIELD_PIGGYBACK_ACK:
+            result['piggyback_ack'] = parse_varint(s)
+        elif field == FIELD_QOS:
+            result['qos'] = parse_varint(s)
         else:
             # Skip unknown field
             if wire == 2:
@@ -146,10 +177,10 @@ def decode_command(buf):
                 parse_varint(s)
                 
     if not any(key in result for key in (
-        "ack", "led", "sound", "move"
+        "ack", "led", "sound", "move", "ack_batch"
     )):
         is_error = True
-        result["error_message"] = "Missing oneof field: ack, led, sound, move"
+        result["error_message"] = "Missing oneof field: ack, led, sound, move, ack_batch"
     
     return is_error, result
 
@@ -30,6 +30,15 @@ def encode_ack_command(acknowledged, reason = None):
     return b
 
 
+def encode_ack_batch_command(offsets):
+    packed = bytearray()
+    for offset in offsets:
+        packed += encode_varint(((offset << 1) ^ (offset >> 31)) & 0xFFFFFFFF)
+    if not packed:
+        return bytearray()
+    return encode_length_delimited(1, packed)
+
+
 def encode_led_command(start, end, duration):
     b = bytearray()
     if start != 0:
@@ -89,9 +98,18 @@ def encode_command(msg):
     elif "sound" in msg:
         payload = encode_sound_command(**msg["sound"])
         b += encode_length_delimited(7, payload)
+    elif "ack_batch" in msg:
+        payload = encode_ack_batch_command(**msg["ack_batch"])
+        b += encode_length_delimited(8, payload)
     else:
-        unknown_cmd_keys = [k for k in msg.keys() if k not in ("id", "source", "target")]
+        unknown_cmd_keys = [k for k in msg.keys() if k not in ("id", "source", "target", "piggyback_ack", "qos")]
         is_error = True
         b = ("Unknown cmd_type: " + ", ".join(unknown_cmd_keys)).encode("utf-8")
+        return is_error, bytes(b)
+
+    if msg.get("piggyback_ack"):
+        b += encode_key(9, 0) + encode_varint(msg["piggyback_ack"])
+    if msg.get("qos"):
+        b += encode_key(10, 0) + encode_varint(msg["qos"])
 
     return is_error, bytes(b)
@@ -79,6 +79,36 @@ def test_send_multiple_messages(stream_mock, C110PCommand):
     assert protoSerial.getUnacknowledgedMessage(1)
     assert protoSerial.getUnacknowledgedMessage(2)
 
+def test_send_varint_frame(stream_mock, C110PCommand):
+    written = bytearray()
+    stream_mock.write.side_effect = lambda data: written.extend(data) or len(data)
+
+    protoSerial = C110PSerial(stream_mock)
+    protoSerial.setFrameFormat(C110PSerial.FRAME_FORMAT_VARINT)
+    msg = C110PCommand(4004, cmd_type="led")
+    msg["led"]["start"] = 1
+
+    assert protoSerial.send(msg)
+    # | START_BYTE | varint(len) | data | crc8 |, one length byte below 128
+    assert written[0] == C110PSerial.START_BYTE
+    length = written[1]
+    assert len(written) == length + 3
+    assert written[-1] == protoSerial.crc8.calculate(written[2:-1])
+
+def test_send_crc16_integrity(stream_mock, C110PCommand):
+    written = bytearray()
+    stream_mock.write.side_effect = lambda data: written.extend(data) or len(data)
+
+    protoSerial = C110PSerial(stream_mock, integrity=C110PSerial.INTEGRITY_CRC16)
+    msg = C110PCommand(5005, cmd_type="led")
+    msg["led"]["start"] = 1
+
+    assert protoSerial.send(msg)
+    # | START_BYTE | len | data | crc16 (low byte first) |
+    length = written[1]
+    assert len(written) == length + 4
+    assert bytes(written[-2:]) == protoSerial.crc.to_bytes(protoSerial.crc.calculate(written[2:-2]))
+
 def test_createLedCommand(stream_mock, C110PCommand):
     proto = C110PSerial(stream_mock, C110PRegion_REGION_DOME)
     target = C110PRegion_REGION_BODY
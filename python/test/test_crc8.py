@@ -1,5 +1,5 @@
 import pytest
-from C110PSerial.CRC8 import CRC8
+from C110PSerial.CRC8 import CRC8, CRC16, CRC32C
 
 @pytest.fixture
 def crc8():
@@ -37,5 +37,15 @@ def test_crc8_calculate_alternating_pattern(crc8):
     data = bytes([0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55])
     assert crc8.calculate(data) == 0x3F
 
+def test_crc16_check_value():
+    # CRC-16/CCITT-FALSE of "123456789"
+    assert CRC16().calculate(b"123456789") == 0x29B1
+    assert CRC16().to_bytes(0x29B1) == bytes([0xB1, 0x29])
+
+def test_crc32c_check_value():
+    # CRC-32C of "123456789"
+    assert CRC32C().calculate(b"123456789") == 0xE3069283
+    assert CRC32C().to_bytes(0xE3069283) == bytes([0x83, 0x92, 0x06, 0xE3])
+
 if __name__ == "__main__":
     pytest.main([__file__])
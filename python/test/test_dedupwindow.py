@@ -0,0 +1,50 @@
+import pytest
+from C110PSerial.DedupWindow import DedupWindow
+
+
+def test_first_seen_then_duplicate():
+    window = DedupWindow()
+    assert window.empty()
+    assert window.check(1000) == DedupWindow.FRESH
+    assert window.check(1000) == DedupWindow.DUPLICATE
+    assert window.contains(1000)
+    assert not window.contains(1001)
+
+def test_out_of_order_inside_window():
+    window = DedupWindow()
+    window.check(5000)
+    assert window.check(4990) == DedupWindow.FRESH
+    assert window.check(5000 - window.WINDOW + 1) == DedupWindow.FRESH
+    assert window.check(4990) == DedupWindow.DUPLICATE
+    assert window.highest() == 5000
+
+def test_below_window_restarts():
+    window = DedupWindow()
+    window.check(100)
+    window.check(100 + window.WINDOW)
+    assert window.check(100) == DedupWindow.FRESH
+    assert window.highest() == 100
+    assert not window.contains(100 + window.WINDOW)
+
+def test_wraps_around_zero():
+    window = DedupWindow()
+    window.check(0xFFFFFFF0)
+    window.check(0xFFFFFFFE)
+    assert window.check(5) == DedupWindow.FRESH
+    assert window.check(0xFFFFFFF0) == DedupWindow.DUPLICATE
+    assert window.check(0xFFFFFFFF) == DedupWindow.FRESH
+
+def test_restarted_peer_starts_over():
+    window = DedupWindow()
+    window.check(3600000)
+    assert window.check(250) == DedupWindow.FRESH
+    assert window.highest() == 250
+    assert window.check(250) == DedupWindow.DUPLICATE
+
+
+def test_covers_default_retry_span():
+    window = DedupWindow()
+    # Other traffic moves the window on while the last retry is pending
+    window.check(5000)
+    window.check(5000 + (1000 << 3))
+    assert window.check(5000) == DedupWindow.DUPLICATE
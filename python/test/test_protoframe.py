@@ -55,6 +55,40 @@ def test_readFrame_wrong_start_byte(stream_mock):
     stream_mock.read.side_effect = [WRONG_START_BYTE, DATA_LEN, *DATA, CRC]
     assert not proto.readFrame()
 
+def test_readFrame_varint_length_spans_reads(stream_mock):
+    proto = ProtoFrame(stream_mock, maxSize=256)
+    proto.setFrameFormat(ProtoFrame.FRAME_FORMAT_VARINT)
+    # A command, then an unknown bytes field padding the payload to 200
+    # bytes, which needs a two byte length
+    _, cmd = encode_command({"id": 42, "source": 0, "target": 0, "led": {"start": 1, "end": 2, "duration": 3}})
+    pad = 200 - len(cmd) - 3
+    DATA = bytes(cmd) + bytes([0x7A, 0x80 | (pad & 0x7F), pad >> 7]) + bytes([0x55] * pad)
+    CRC = proto.crc8.calculate(DATA)
+    frame = [proto.START_BYTE, 0x80 | 72, 1, *DATA, CRC]
+    # The length field is split across two readFrame() calls
+    stream_mock.any.side_effect = [1, 1, 0] + [1] * (len(frame) - 2) + [0]
+    stream_mock.read.side_effect = frame
+    assert not proto.readFrame()
+    assert proto.readFrame()
+    assert proto.getLastReceivedMessage()["id"] == 42
+
+def test_readFrame_varint_overlong_length(stream_mock):
+    proto = ProtoFrame(stream_mock)
+    proto.setFrameFormat(ProtoFrame.FRAME_FORMAT_VARINT)
+    stream_mock.any.side_effect = [1, 1, 1, 0]
+    stream_mock.read.side_effect = [proto.START_BYTE, 0x80, 0x00]
+    assert not proto.readFrame()
+
+def test_readFrame_crc32c_integrity(stream_mock):
+    proto = ProtoFrame(stream_mock, integrity=ProtoFrame.INTEGRITY_CRC32C)
+    err, DATA = encode_command({"id": 42, "led": {"start": 1, "end": 2, "duration": 0}})
+    CRC = proto.crc.to_bytes(proto.crc.calculate(DATA))
+    read_side_effects = [proto.START_BYTE, len(DATA), *DATA, *CRC]
+    stream_mock.any.side_effect = [1] * len(read_side_effects) + [0]
+    stream_mock.read.side_effect = read_side_effects
+    assert proto.readFrame()
+    assert proto.getLastReceivedMessage()["id"] == 42
+
 def test_handleAck_acknowledges_message(stream_mock, C110PCommand):
     proto = ProtoFrame(stream_mock)
     sent_msg = C110PCommand(id=12345, cmd_type='ack')
@@ -312,7 +346,7 @@ def test_receiveMessage_decodes_and_processes_new_message(stream_mock, C110PComm
     assert proto.lastMsg["id"] == 1234
     assert proto.sendAckCalled == 1
     assert proto.lastAckTimestamp == 1234
-    assert proto.m_receivedMessageBuffer.contains(1234)
+    assert proto.receivedIds(0).contains(1234)
 
 def test_receiveMessage_duplicate_message_only_acks(stream_mock, C110PCommand):
     class TestProtoFrame(ProtoFrame):
@@ -327,13 +361,61 @@ def test_receiveMessage_duplicate_message_only_acks(stream_mock, C110PCommand):
             self.lastAckTimestamp = ts
     proto = TestProtoFrame(stream_mock)
     msg = C110PCommand(id=4321, cmd_type='move')
-    proto.m_receivedMessageBuffer.add(msg)
+    proto.receivedIds(0).check(msg["id"])
     err, buffer = encode_command(msg)
     proto.receiveMessage(buffer)
     assert proto.processCalled == 0
     assert proto.sendAckCalled == 1
     assert proto.lastAckTimestamp == 4321
 
+def test_receiveMessage_ack_batch_clears_every_covered_message(stream_mock):
+    class TestProtoFrame(ProtoFrame):
+        def __init__(self, *a, **kw):
+            super().__init__(*a, **kw)
+            self.sendAckCalled = 0
+        def sendAck(self, ts): self.sendAckCalled += 1
+    proto = TestProtoFrame(stream_mock)
+    for ts in (3000, 3040, 2950, 4000):
+        proto.m_messageInfoMap[ts] = {'lastProcessedTimestamp': ts, 'retryCount': 0}
+    err, buffer = encode_command({"id": 3000, "ack_batch": {"offsets": [40, -50]}})
+    assert not err
+    proto.receiveMessage(buffer)
+    assert list(proto.m_messageInfoMap) == [4000]
+    # ACKs are not acknowledged
+    assert proto.sendAckCalled == 0
+
+def test_receiveMessage_piggyback_ack_clears_message(stream_mock):
+    class TestProtoFrame(ProtoFrame):
+        def __init__(self, *a, **kw):
+            super().__init__(*a, **kw)
+            self.acked = []
+        def sendAck(self, ts): self.acked.append(ts)
+    proto = TestProtoFrame(stream_mock)
+    for ts in (6000, 6010):
+        proto.m_messageInfoMap[ts] = {'lastProcessedTimestamp': ts, 'retryCount': 0}
+    err, buffer = encode_command({"id": 9100, "led": {"start": 1, "end": 2, "duration": 0}, "piggyback_ack": 6010})
+    assert not err
+    proto.receiveMessage(buffer)
+    assert list(proto.m_messageInfoMap) == [6000]
+    # The command itself is ACKed as usual
+    assert proto.acked == [9100]
+
+def test_receiveMessage_best_effort_is_not_acked(stream_mock):
+    class TestProtoFrame(ProtoFrame):
+        def __init__(self, *a, **kw):
+            super().__init__(*a, **kw)
+            self.processCalled = 0
+            self.sendAckCalled = 0
+        def processCallback(self, msg): self.processCalled += 1
+        def sendAck(self, ts): self.sendAckCalled += 1
+    proto = TestProtoFrame(stream_mock)
+    err, buffer = encode_command({"id": 888, "source": 1, "move": {"target": 1, "x": 10}, "qos": 1})
+    assert not err
+    proto.receiveMessage(buffer)
+    proto.receiveMessage(buffer)
+    assert proto.processCalled == 1
+    assert proto.sendAckCalled == 0
+
 def test_receiveMessage_invalid_protobuf_does_nothing(stream_mock):
     class TestProtoFrame(ProtoFrame):
         def __init__(self, *a, **kw):
@@ -23,6 +23,17 @@ C110PCommand createValidMsg(uint32_t timestamp = 1234)
     return msg;
 }
 
+// Helper: Frame `msg` as a peer would send it; returns the frame length
+size_t frameMsg(const C110PCommand& msg, uint8_t* frame, size_t size)
+{
+    frame[0] = static_cast<uint8_t>(C110PSerial::START_BYTE);
+    pb_ostream_t stream = pb_ostream_from_buffer(&frame[2], size - 3);
+    TEST_ASSERT_TRUE(pb_encode(&stream, C110PCommand_fields, &msg));
+    frame[1] = static_cast<uint8_t>(stream.bytes_written);
+    frame[2 + stream.bytes_written] = crc8.calculate(&frame[2], stream.bytes_written);
+    return stream.bytes_written + 3;
+}
+
 void test_send_successful(void)
 {
     std::vector<uint8_t> written;
@@ -131,6 +142,414 @@ void test_send_multiple_messages(void)
     TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(2));
 }
 
+void test_send_cobs_frame(void)
+{
+    std::vector<uint8_t> written;
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    protoSerial.setFrameFormat(C110PSerial::FrameFormat::Cobs);
+    C110PCommand msg = createValidMsg(3003);
+
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&written](const uint8_t* data, size_t len) {
+            for (size_t i = 0; i < len; ++i) {
+                written.push_back(data[i]);
+            }
+            return len;
+        });
+
+    TEST_ASSERT_TRUE(protoSerial.send(msg));
+
+    // Only the trailing delimiter may be zero
+    TEST_ASSERT_GREATER_THAN(2, written.size());
+    TEST_ASSERT_EQUAL(COBS::DELIMITER, written.back());
+    for (size_t i = 0; i + 1 < written.size(); ++i) {
+        TEST_ASSERT_NOT_EQUAL(COBS::DELIMITER, written[i]);
+    }
+
+    // Decoded block is [data...][crc]
+    uint8_t decoded[ProtoFrame::COBS_MAX_SIZE];
+    size_t decodedLen = COBS::decode(written.data(), written.size() - 1, decoded);
+    TEST_ASSERT_GREATER_THAN(1, decodedLen);
+    TEST_ASSERT_EQUAL_HEX8(crc8.calculate(decoded, decodedLen - 1), decoded[decodedLen - 1]);
+
+    pb_istream_t stream = pb_istream_from_buffer(decoded, decodedLen - 1);
+    C110PCommand msgCopy = C110PCommand_init_zero;
+    TEST_ASSERT_TRUE(pb_decode(&stream, C110PCommand_fields, &msgCopy));
+    TEST_ASSERT_EQUAL(msg.id, msgCopy.id);
+}
+
+void test_send_varint_frame(void)
+{
+    std::vector<uint8_t> written;
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    protoSerial.setFrameFormat(C110PSerial::FrameFormat::Varint);
+    C110PCommand msg = createValidMsg(4004);
+
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&written](const uint8_t* data, size_t len) {
+            written.insert(written.end(), data, data + len);
+            return len;
+        });
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(uint8_t)))
+        .AlwaysDo([&written](uint8_t b) {
+            written.push_back(b);
+            return size_t(1);
+        });
+
+    TEST_ASSERT_TRUE(protoSerial.send(msg));
+
+    // | START_BYTE | varint(len) | data | crc8 |, one length byte below 128
+    TEST_ASSERT_GREATER_THAN(3, written.size());
+    TEST_ASSERT_EQUAL_HEX8(C110PSerial::START_BYTE, written[0]);
+    size_t len = written[1];
+    TEST_ASSERT_EQUAL(len + 3, written.size());
+    TEST_ASSERT_EQUAL_HEX8(crc8.calculate(&written[2], len), written.back());
+}
+
+void test_send_crc16_integrity(void)
+{
+    std::vector<uint8_t> written;
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock, C110PRegion_REGION_UNSPECIFIED, 1000, C110PSerial::Integrity::Crc16);
+    C110PCommand msg = createValidMsg(5005);
+
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&written](const uint8_t* data, size_t len) {
+            written.insert(written.end(), data, data + len);
+            return len;
+        });
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(uint8_t)))
+        .AlwaysDo([&written](uint8_t b) {
+            written.push_back(b);
+            return size_t(1);
+        });
+
+    TEST_ASSERT_TRUE(protoSerial.send(msg));
+
+    // | START_BYTE | len | data | crc16 (low byte first) |
+    size_t len = written[1];
+    TEST_ASSERT_EQUAL(len + 4, written.size());
+    uint16_t crc = Crc16Ccitt::calculate(&written[2], len);
+    TEST_ASSERT_EQUAL_HEX8(crc & 0xFF, written[len + 2]);
+    TEST_ASSERT_EQUAL_HEX8(crc >> 8, written[len + 3]);
+}
+
+void test_send_ack_is_neither_kept_nor_tracked(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([](const uint8_t*, size_t len) { return len; });
+
+    C110PCommand ack = C110PCommand_init_default;
+    ack.id = 6006;
+    ack.which_data = C110PCommand_ack_tag;
+    ack.data.ack.acknowledged = true;
+    TEST_ASSERT_TRUE(protoSerial.send(ack));
+
+    TEST_ASSERT_EQUAL(0, protoSerial.getSentMessageBufferSize());
+    TEST_ASSERT_EQUAL(0, protoSerial.getUnacknowledgedMessagesSize());
+    Verify(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).Once();
+}
+
+void test_send_piggybacks_held_ack(void)
+{
+    std::vector<uint8_t> written;
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&written](const uint8_t* data, size_t len) {
+            written.insert(written.end(), data, data + len);
+            return len;
+        });
+
+    protoSerial.setTimestampProvider([]() -> uint64_t { return 50000; });
+    protoSerial.setAckCoalescing(20, 1);
+    protoSerial.setPiggybackAcks(true);
+
+    // Received from the peer: its ACK is held rather than written
+    uint8_t frame[64];
+    SpscByteRing<64> ring;
+    ring.push(frame, frameMsg(createValidMsg(7007), frame, sizeof(frame)));
+    protoSerial.setRxRing(&ring);
+    TEST_ASSERT_EQUAL(1, protoSerial.processQueue());
+    TEST_ASSERT_EQUAL(0, written.size());
+
+    TEST_ASSERT_TRUE(protoSerial.send(createValidMsg(8008)));
+
+    pb_istream_t stream = pb_istream_from_buffer(written.data() + 2, written[1]);
+    C110PCommand sent = C110PCommand_init_zero;
+    TEST_ASSERT_TRUE(pb_decode(&stream, C110PCommand_fields, &sent));
+    TEST_ASSERT_EQUAL_UINT32(8008, sent.id);
+    TEST_ASSERT_EQUAL_UINT32(7007, sent.piggyback_ack);
+
+    // Nothing left to go out on its own
+    written.clear();
+    protoSerial.flushAcks();
+    TEST_ASSERT_EQUAL(0, written.size());
+}
+
+void test_send_window_blocks_until_acked(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([](const uint8_t*, size_t len) { return len; });
+    protoSerial.setTimestampProvider([]() -> uint64_t { return 60000; });
+
+    protoSerial.setSendWindow(2);
+    TEST_ASSERT_TRUE(protoSerial.sendWindowOpen());
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(createValidMsg(101)));
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(createValidMsg(102)));
+    TEST_ASSERT_FALSE(protoSerial.sendWindowOpen());
+
+    // Nothing is written or tracked past the window
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::WouldBlock, protoSerial.trySend(createValidMsg(103)));
+    TEST_ASSERT_FALSE(protoSerial.send(createValidMsg(103)));
+    TEST_ASSERT_EQUAL(2, protoSerial.getSentMessageBufferSize());
+    TEST_ASSERT_FALSE(protoSerial.getUnacknowledgedMessage(103));
+    Verify(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).Exactly(2);
+
+    // The peer's ACK opens it again
+    C110PCommand ack = C110PCommand_init_default;
+    ack.id = 101;
+    ack.which_data = C110PCommand_ack_tag;
+    ack.data.ack.acknowledged = true;
+    uint8_t frame[64];
+    SpscByteRing<64> ring;
+    ring.push(frame, frameMsg(ack, frame, sizeof(frame)));
+    protoSerial.setRxRing(&ring);
+    protoSerial.processQueue();
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(createValidMsg(103)));
+    TEST_ASSERT_FALSE(protoSerial.sendWindowOpen());
+
+    // 0 turns the limit off
+    protoSerial.setSendWindow(0);
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(createValidMsg(104)));
+}
+
+static uint64_t s_windowNow = 60000;
+
+void test_send_window_keeps_long_frames_in_flight(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    size_t writes = 0;
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&writes](const uint8_t*, size_t len) { writes++; return len; });
+    s_windowNow = 60000;
+    protoSerial.setTimestampProvider([]() -> uint64_t { return s_windowNow; });
+
+    // Frames past SENT_FRAME_BUDGET: the arena fills before the window does,
+    // and the next send blocks rather than evict a frame in flight
+    std::vector<uint32_t> sent;
+    for (uint32_t id = 0x10000000; sent.size() <= protoSerial.sendWindow(); ++id)
+    {
+        C110PCommand move = protoSerial.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK,
+                                                          0xFFFFFFF0, 0xFFFFFFF0, 0xFFFFFFF0);
+        move.id = id;
+        C110PSerial::SendStatus status = protoSerial.trySend(move);
+        if (status == C110PSerial::SendStatus::WouldBlock)
+        {
+            break;
+        }
+        TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, status);
+        TEST_ASSERT_GREATER_THAN(SENT_FRAME_BUDGET, protoSerial.sentFrames().get(id).length);
+        sent.push_back(id);
+    }
+    TEST_ASSERT_TRUE(protoSerial.sendWindowOpen());
+    for (uint32_t id : sent)
+    {
+        TEST_ASSERT_TRUE(protoSerial.sentFrames().contains(id));
+    }
+
+    // Each one is retried once its timeout has passed
+    writes = 0;
+    s_windowNow += 2000;
+    SpscByteRing<64> ring;
+    protoSerial.setRxRing(&ring);
+    protoSerial.processQueue();
+    TEST_ASSERT_EQUAL(sent.size(), writes);
+    TEST_ASSERT_EQUAL(sent.size(), protoSerial.getUnacknowledgedMessagesSize());
+}
+
+void test_send_best_effort_is_not_tracked(void)
+{
+    std::vector<uint8_t> written;
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&written](const uint8_t* data, size_t len) {
+            written.insert(written.end(), data, data + len);
+            return len;
+        });
+
+    // Per message
+    C110PCommand msg = createValidMsg(201);
+    msg.qos = C110PQos_QOS_BEST_EFFORT;
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(msg));
+    TEST_ASSERT_EQUAL(0, protoSerial.getSentMessageBufferSize());
+    TEST_ASSERT_EQUAL(0, protoSerial.getUnacknowledgedMessagesSize());
+
+    // Per type, and past a full window
+    protoSerial.setSendWindow(1);
+    TEST_ASSERT_TRUE(protoSerial.send(createValidMsg(202)));
+    protoSerial.setQos(C110PCommand_led_tag, C110PQos_QOS_BEST_EFFORT);
+    written.clear();
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(createValidMsg(203)));
+    TEST_ASSERT_EQUAL(1, protoSerial.getUnacknowledgedMessagesSize());
+    TEST_ASSERT_FALSE(protoSerial.getUnacknowledgedMessage(203));
+
+    // The class goes out in the frame, for the receiver
+    pb_istream_t stream = pb_istream_from_buffer(written.data() + 2, written[1]);
+    C110PCommand sent = C110PCommand_init_zero;
+    TEST_ASSERT_TRUE(pb_decode(&stream, C110PCommand_fields, &sent));
+    TEST_ASSERT_EQUAL_UINT32(203, sent.id);
+    TEST_ASSERT_EQUAL(C110PQos_QOS_BEST_EFFORT, sent.qos);
+
+    protoSerial.setQos(C110PCommand_led_tag, C110PQos_QOS_RELIABLE);
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::WouldBlock, protoSerial.trySend(createValidMsg(204)));
+}
+
+void test_send_latest_value_supersedes_older(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([](const uint8_t*, size_t len) { return len; });
+
+    protoSerial.setLatestValue(C110PCommand_move_tag, true);
+    C110PCommand move = protoSerial.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK, 10);
+    move.id = 301;
+    TEST_ASSERT_TRUE(protoSerial.send(move));
+    C110PCommand other = protoSerial.createMoveCommand(C110PRegion_REGION_BODY, C110PActuator_BODY_NECK, 10);
+    other.id = 302;
+    TEST_ASSERT_TRUE(protoSerial.send(other));
+    TEST_ASSERT_TRUE(protoSerial.send(createValidMsg(303)));
+
+    // Same target and actuator: only the newer one is still retried
+    move.id = 304;
+    move.data.move.x = 20;
+    protoSerial.setSendWindow(3);
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Sent, protoSerial.trySend(move));
+    TEST_ASSERT_FALSE(protoSerial.getUnacknowledgedMessage(301));
+    TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(302));
+    TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(303));
+    TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(304));
+
+    // Types where every command counts are never superseded
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::WouldBlock, protoSerial.trySend(createValidMsg(305)));
+}
+
+void test_enqueue_drains_by_class_within_write_room(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    int room = 0;
+    When(Method(ArduinoFake(Stream), availableForWrite)).AlwaysDo([&room]() { return room; });
+    When(OverloadedMethod(ArduinoFake(Stream), write,  size_t(const uint8_t*, size_t)))
+        .AlwaysDo([&room](const uint8_t*, size_t len) { room = 0; return len; });
+    protoSerial.setSendWindow(0);
+    protoSerial.setWriteRoomCheck(true);
+    protoSerial.setEmergency(C110PCommand_move_tag, true);
+
+    C110PCommand sound = protoSerial.createSoundCommand(C110PRegion_REGION_DOME, 1);
+    sound.id = 401;
+    C110PCommand led = createValidMsg(402);
+    C110PCommand move = protoSerial.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK, 10);
+    move.id = 403;
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(sound));
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(led));
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(move));
+    TEST_ASSERT_EQUAL(1, protoSerial.txQueued(C110PSerial::TxClass::Emergency));
+
+    // No room on the link: nothing is written or tracked yet
+    TEST_ASSERT_EQUAL(0, protoSerial.drainTxQueue());
+    TEST_ASSERT_EQUAL(3, protoSerial.txQueued());
+    TEST_ASSERT_EQUAL_UINT32(0, protoSerial.getUnacknowledgedMessagesSize());
+
+    // Room for one frame at a time: the emergency move, then the LED
+    // command ahead of the sound
+    room = 100;
+    TEST_ASSERT_EQUAL(1, protoSerial.drainTxQueue());
+    TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(403));
+    room = 100;
+    TEST_ASSERT_EQUAL(1, protoSerial.drainTxQueue());
+    TEST_ASSERT_TRUE(protoSerial.getUnacknowledgedMessage(402));
+    TEST_ASSERT_FALSE(protoSerial.getUnacknowledgedMessage(401));
+    room = 100;
+    TEST_ASSERT_EQUAL(1, protoSerial.drainTxQueue());
+    TEST_ASSERT_EQUAL(0, protoSerial.txQueued());
+}
+
+// Leaves availableForWrite() to Print, which reports 0
+class UnsizedStream : public Stream
+{
+public:
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+    size_t write(uint8_t) override { bytes++; return 1; }
+    size_t write(const uint8_t*, size_t size) override { bytes += size; frames++; return size; }
+
+    size_t bytes = 0;
+    size_t frames = 0;
+};
+
+void test_enqueue_drains_on_stream_without_write_room(void)
+{
+    UnsizedStream stream;
+    C110PSerial protoSerial(&stream);
+
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(createValidMsg(801)));
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(createValidMsg(802)));
+    TEST_ASSERT_EQUAL(2, protoSerial.drainTxQueue());
+    TEST_ASSERT_EQUAL(2, stream.frames);
+    TEST_ASSERT_EQUAL(0, protoSerial.txQueued());
+}
+
+void test_enqueue_without_queue_writes_at_once(void)
+{
+    UnsizedStream stream;
+    BasicC110PSerial<ProtoFrameConfigSmall> protoSerial(&stream);
+
+    // The Small preset has no TX queue: enqueue() is a send
+    TEST_ASSERT_EQUAL(BasicC110PSerial<ProtoFrameConfigSmall>::SendStatus::Sent, protoSerial.enqueue(createValidMsg(811)));
+    TEST_ASSERT_EQUAL(1, stream.frames);
+    TEST_ASSERT_EQUAL(0, protoSerial.txQueued());
+    TEST_ASSERT_EQUAL(0, protoSerial.drainTxQueue());
+
+    // The room check still holds it back
+    protoSerial.setWriteRoomCheck(true);
+    TEST_ASSERT_EQUAL(BasicC110PSerial<ProtoFrameConfigSmall>::SendStatus::WouldBlock, protoSerial.enqueue(createValidMsg(812)));
+    TEST_ASSERT_EQUAL(1, stream.frames);
+}
+
+void test_enqueue_latest_value_replaces_queued(void)
+{
+    Stream* streamMock = ArduinoFakeMock(Stream);
+    C110PSerial protoSerial(streamMock);
+    protoSerial.setLatestValue(C110PCommand_move_tag, true);
+
+    C110PCommand move = protoSerial.createMoveCommand(C110PRegion_REGION_DOME, C110PActuator_BODY_NECK, 10);
+    move.id = 501;
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(move));
+    move.id = 502;
+    move.data.move.x = 20;
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(move));
+    TEST_ASSERT_EQUAL(1, protoSerial.txQueued(C110PSerial::TxClass::Move));
+
+    // Every LED command counts, so a full queue refuses the next
+    for (uint32_t i = 0; i < TX_QUEUE_DEPTH; ++i)
+    {
+        TEST_ASSERT_EQUAL(C110PSerial::SendStatus::Queued, protoSerial.enqueue(createValidMsg(600 + i)));
+    }
+    TEST_ASSERT_EQUAL(C110PSerial::SendStatus::WouldBlock, protoSerial.enqueue(createValidMsg(700)));
+}
+
 void test_createLedCommand(void)
 {
     Stream* streamPtr = ArduinoFakeMock(Stream);
@@ -190,6 +609,19 @@ int test_protoserial_suite(void)
     RUN_TEST(test_send_successful);
     RUN_TEST(test_send_stream_write_failure);
     RUN_TEST(test_send_multiple_messages);
+    RUN_TEST(test_send_cobs_frame);
+    RUN_TEST(test_send_varint_frame);
+    RUN_TEST(test_send_crc16_integrity);
+    RUN_TEST(test_send_ack_is_neither_kept_nor_tracked);
+    RUN_TEST(test_send_piggybacks_held_ack);
+    RUN_TEST(test_send_window_blocks_until_acked);
+    RUN_TEST(test_send_window_keeps_long_frames_in_flight);
+    RUN_TEST(test_send_best_effort_is_not_tracked);
+    RUN_TEST(test_send_latest_value_supersedes_older);
+    RUN_TEST(test_enqueue_drains_by_class_within_write_room);
+    RUN_TEST(test_enqueue_drains_on_stream_without_write_room);
+    RUN_TEST(test_enqueue_without_queue_writes_at_once);
+    RUN_TEST(test_enqueue_latest_value_replaces_queued);
     RUN_TEST(test_createLedCommand);
     RUN_TEST(test_createSoundCommand);
     RUN_TEST(test_createMoveCommand);
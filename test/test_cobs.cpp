@@ -0,0 +1,107 @@
+#include "unity.h"
+
+#include "COBS.h"
+
+
+static void assertRoundTrip(const uint8_t* data, size_t len, const uint8_t* expected, size_t expectedLen)
+{
+    uint8_t encoded[COBS::maxEncodedSize(300)];
+    uint8_t decoded[300];
+
+    size_t encodedLen = COBS::encode(data, len, encoded);
+    TEST_ASSERT_EQUAL(expectedLen, encodedLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, encoded, expectedLen);
+
+    size_t decodedLen = COBS::decode(encoded, encodedLen, decoded);
+    TEST_ASSERT_EQUAL(len, decodedLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, decoded, len);
+}
+
+// Test COBS::encode/decode with a single zero
+void test_COBS_SingleZero(void) {
+    const uint8_t data[] = {0x00};
+    const uint8_t expected[] = {0x01, 0x01};
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::encode/decode with zeros between data
+void test_COBS_EmbeddedZero(void) {
+    const uint8_t data[] = {0x11, 0x22, 0x00, 0x33};
+    const uint8_t expected[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::encode/decode with no zeros
+void test_COBS_NoZero(void) {
+    const uint8_t data[] = {0x11, 0x22, 0x33, 0x44};
+    const uint8_t expected[] = {0x05, 0x11, 0x22, 0x33, 0x44};
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::encode/decode with trailing zeros
+void test_COBS_TrailingZeros(void) {
+    const uint8_t data[] = {0x11, 0x00, 0x00, 0x00};
+    const uint8_t expected[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::encode/decode with a full 254 byte block
+void test_COBS_FullBlock(void) {
+    uint8_t data[254];
+    uint8_t expected[255];
+    expected[0] = 0xFF;
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i + 1);
+        expected[i + 1] = data[i];
+    }
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::encode/decode with a block split after 254 bytes
+void test_COBS_SplitBlock(void) {
+    uint8_t data[255];
+    uint8_t expected[257];
+    expected[0] = 0xFF;
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i + 1);
+    }
+    for (size_t i = 0; i < 254; ++i)
+    {
+        expected[i + 1] = data[i];
+    }
+    expected[255] = 0x02;
+    expected[256] = 0xFF;
+    assertRoundTrip(data, sizeof(data), expected, sizeof(expected));
+}
+
+// Test COBS::decode rejects delimiters and truncated blocks
+void test_COBS_DecodeMalformed(void) {
+    uint8_t decoded[8];
+    const uint8_t delimiter[] = {0x02, 0x00};
+    const uint8_t truncated[] = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL(0, COBS::decode(delimiter, sizeof(delimiter), decoded));
+    TEST_ASSERT_EQUAL(0, COBS::decode(truncated, sizeof(truncated), decoded));
+}
+
+// Test COBS::decode can decode in place
+void test_COBS_DecodeInPlace(void) {
+    uint8_t buffer[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    const uint8_t expected[] = {0x11, 0x22, 0x00, 0x33};
+    TEST_ASSERT_EQUAL(sizeof(expected), COBS::decode(buffer, sizeof(buffer), buffer));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+int test_cobs_suite(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_COBS_SingleZero);
+    RUN_TEST(test_COBS_EmbeddedZero);
+    RUN_TEST(test_COBS_NoZero);
+    RUN_TEST(test_COBS_TrailingZeros);
+    RUN_TEST(test_COBS_FullBlock);
+    RUN_TEST(test_COBS_SplitBlock);
+    RUN_TEST(test_COBS_DecodeMalformed);
+    RUN_TEST(test_COBS_DecodeInPlace);
+    return UNITY_END();
+}
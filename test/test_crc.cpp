@@ -0,0 +1,56 @@
+#include <unity.h>
+#include <cstring>
+#include "CRC.h"
+
+static constexpr uint8_t CHECK[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+// Tables and byte-wise evaluation are usable in constant expressions
+static_assert(Crc8::calculate(CHECK, sizeof(CHECK)) == 0xF4, "CRC-8 check value");
+static_assert(Crc16Ccitt::calculate(CHECK, sizeof(CHECK)) == 0x29B1, "CRC-16/CCITT-FALSE check value");
+static_assert(Crc32::calculate(CHECK, sizeof(CHECK)) == 0xCBF43926, "CRC-32 check value");
+static_assert(Crc32C::calculate(CHECK, sizeof(CHECK)) == 0xE3069283, "CRC-32C check value");
+
+// Test the catalogue check values at runtime
+void test_Crc_CheckValues(void) {
+    TEST_ASSERT_EQUAL_HEX8(0xF4, Crc8::calculate(CHECK, sizeof(CHECK)));
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, Crc16Ccitt::calculate(CHECK, sizeof(CHECK)));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, Crc32::calculate(CHECK, sizeof(CHECK)));
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, Crc32C::calculate(CHECK, sizeof(CHECK)));
+}
+
+// Test that slicing-by-4/8 matches byte-wise for every length and tail
+void test_Crc_SlicedMatchesBytewise(void) {
+    uint8_t data[67];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    for (size_t len = 0; len <= sizeof(data); ++len) {
+        TEST_ASSERT_EQUAL_HEX16(Crc16Ccitt::calculate(data, len), Crc16Ccitt::calculateSliced<4>(data, len));
+        TEST_ASSERT_EQUAL_HEX16(Crc16Ccitt::calculate(data, len), Crc16Ccitt::calculateSliced<8>(data, len));
+        TEST_ASSERT_EQUAL_HEX32(Crc32::calculate(data, len), Crc32::calculateSliced<4>(data, len));
+        TEST_ASSERT_EQUAL_HEX32(Crc32::calculate(data, len), Crc32::calculateSliced<8>(data, len));
+        TEST_ASSERT_EQUAL_HEX32(Crc32C::calculate(data, len), Crc32C::calculateSliced<8>(data, len));
+    }
+}
+
+// Test that feeding data in pieces gives the one-shot result
+void test_Crc_StreamingMatchesOneShot(void) {
+    uint32_t crc = Crc32C::begin();
+    crc = Crc32C::update(crc, CHECK, 4);
+    crc = Crc32C::updateSliced<8>(crc, CHECK + 4, 5);
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, Crc32C::finish(crc));
+
+    uint16_t crc16 = Crc16Ccitt::begin();
+    for (uint8_t byte : CHECK) {
+        crc16 = Crc16Ccitt::step(crc16, byte);
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, Crc16Ccitt::finish(crc16));
+}
+
+int test_crc_suite(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_Crc_CheckValues);
+    RUN_TEST(test_Crc_SlicedMatchesBytewise);
+    RUN_TEST(test_Crc_StreamingMatchesOneShot);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+#include <stdint.h>
+
+#include "DedupWindow.h"
+#include "ProtoFrameConfig.h"
+
+using namespace fakeit;
+
+using Result = DedupWindow<>::Result;
+
+void test_Dedup_FirstSeenThenDuplicate(void)
+{
+    DedupWindow<> window;
+
+    TEST_ASSERT_TRUE(window.empty());
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(1000));
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(1000));
+    TEST_ASSERT_TRUE(window.contains(1000));
+    TEST_ASSERT_FALSE(window.contains(1001));
+}
+
+void test_Dedup_OutOfOrderInsideWindow(void)
+{
+    DedupWindow<> window;
+
+    window.check(5000);
+    // Older ids that have not been seen yet are still accepted, once
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(4990));
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(5000 - DedupWindow<>::WINDOW + 1));
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(4990));
+    TEST_ASSERT_EQUAL_UINT32(5000, window.highest());
+}
+
+void test_Dedup_RemembersFarMoreThanTheOldHistory(void)
+{
+    DedupWindow<> window;
+
+    // Ids spaced like a message every 2 ms; the 25 message history forgot
+    // all but the last 25 of these
+    for (uint32_t id = 10000; id < 10000 + 900; id += 2)
+    {
+        TEST_ASSERT_EQUAL(Result::Fresh, window.check(id));
+    }
+    for (uint32_t id = 10000 + 2 * 40; id < 10000 + 900; id += 2)
+    {
+        TEST_ASSERT_EQUAL(Result::Duplicate, window.check(id));
+    }
+}
+
+void test_Dedup_BelowWindowRestarts(void)
+{
+    DedupWindow<> window;
+
+    window.check(100);
+    window.check(100 + DedupWindow<>::WINDOW);
+    // 100 itself has slid out, so it can only come from a peer that
+    // restarted; the window starts over from it
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(100));
+    TEST_ASSERT_EQUAL_UINT32(100, window.highest());
+    TEST_ASSERT_TRUE(window.contains(100));
+    TEST_ASSERT_FALSE(window.contains(100 + DedupWindow<>::WINDOW));
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(101));
+}
+
+void test_Dedup_AdvancingClearsPassedIds(void)
+{
+    DedupWindow<64> window;
+
+    // Walk the window over its own ring several times; ids that share a
+    // bitmap word with an earlier id must come back fresh
+    for (uint32_t id = 0; id < 640; id += 5)
+    {
+        TEST_ASSERT_EQUAL(Result::Fresh, window.check(id));
+        TEST_ASSERT_EQUAL(Result::Fresh, window.check(id + 2));
+        TEST_ASSERT_EQUAL(Result::Duplicate, window.check(id));
+    }
+}
+
+void test_Dedup_WrapsAroundZero(void)
+{
+    DedupWindow<> window;
+
+    window.check(0xFFFFFFF0u);
+    window.check(0xFFFFFFFEu);
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(5));
+    TEST_ASSERT_EQUAL_UINT32(5, window.highest());
+    // Ids from before the wrap are still remembered
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(0xFFFFFFF0u));
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(0xFFFFFFFEu));
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(0xFFFFFFFFu));
+}
+
+void test_Dedup_RestartedPeerStartsOver(void)
+{
+    DedupWindow<> window;
+
+    window.check(3600000);
+    // The peer rebooted and its millisecond clock started from zero again
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(250));
+    TEST_ASSERT_EQUAL_UINT32(250, window.highest());
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(250));
+}
+
+void test_Dedup_Reset(void)
+{
+    DedupWindow<> window;
+
+    window.check(42);
+    window.reset();
+    TEST_ASSERT_TRUE(window.empty());
+    TEST_ASSERT_EQUAL(Result::Fresh, window.check(42));
+}
+
+void test_Dedup_CoversDefaultRetrySpan(void)
+{
+    using Config = ProtoFrameConfigDefault;
+    DedupWindow<Config::DEDUP_BITS> window;
+    const uint32_t span = Config::TIMEOUT_MS << Config::MAX_RETRIES;
+
+    // Other traffic moves the window on while the last retry is pending
+    window.check(5000);
+    window.check(5000 + span);
+    TEST_ASSERT_EQUAL(Result::Duplicate, window.check(5000));
+}
+
+void test_Dedup_FewHundredBytes(void)
+{
+    TEST_ASSERT_TRUE(sizeof(DedupWindow<1024>) <= 1024 / 8 + 8);
+}
+
+void test_Dedup_WindowSizedFromRetrySpan(void)
+{
+    TEST_ASSERT_EQUAL(DEDUP_WINDOW_BITS, ProtoFrameConfigDefault::DEDUP_BITS);
+    TEST_ASSERT_EQUAL(64, dedupWindowBits(32));
+    TEST_ASSERT_EQUAL(128, dedupWindowBits(33));
+    TEST_ASSERT_EQUAL(1024, (ProtoFrameConfig<128, 32, 64, SystemClock, Crc8Policy, 240, 2>::DEDUP_BITS));
+}
+
+void test_Dedup_PeersTakeWindowsAsTheySend(void)
+{
+    DedupPeers<64, 2> peers;
+
+    TEST_ASSERT_EQUAL(Result::Fresh, peers[1].check(500));
+    TEST_ASSERT_EQUAL(Result::Fresh, peers[2].check(500));
+    TEST_ASSERT_EQUAL(Result::Duplicate, peers[1].check(500));
+    TEST_ASSERT_EQUAL(Result::Duplicate, peers[2].check(500));
+
+    // A third source takes the window of 1, heard from least recently
+    TEST_ASSERT_EQUAL(Result::Fresh, peers[3].check(500));
+    TEST_ASSERT_EQUAL(Result::Duplicate, peers[2].check(500));
+    TEST_ASSERT_EQUAL(Result::Fresh, peers[1].check(500));
+
+    peers.reset();
+    TEST_ASSERT_EQUAL(Result::Fresh, peers[1].check(500));
+}
+
+int test_dedup_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Dedup_FirstSeenThenDuplicate);
+    RUN_TEST(test_Dedup_OutOfOrderInsideWindow);
+    RUN_TEST(test_Dedup_RemembersFarMoreThanTheOldHistory);
+    RUN_TEST(test_Dedup_BelowWindowRestarts);
+    RUN_TEST(test_Dedup_AdvancingClearsPassedIds);
+    RUN_TEST(test_Dedup_WrapsAroundZero);
+    RUN_TEST(test_Dedup_RestartedPeerStartsOver);
+    RUN_TEST(test_Dedup_Reset);
+    RUN_TEST(test_Dedup_CoversDefaultRetrySpan);
+    RUN_TEST(test_Dedup_FewHundredBytes);
+    RUN_TEST(test_Dedup_WindowSizedFromRetrySpan);
+    RUN_TEST(test_Dedup_PeersTakeWindowsAsTheySend);
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "FrameCache.h"
+
+using namespace fakeit;
+
+// Store `length` bytes of `fill` as the frame of `id`
+template<typename Cache>
+static void storeFrame(Cache& cache, uint32_t id, size_t length, size_t reserve = 16)
+{
+    uint8_t* frame = cache.reserve(reserve);
+    memset(frame, static_cast<int>(id & 0xFF), length);
+    cache.commit(id, length);
+}
+
+template<typename Cache>
+static bool frameIntact(const Cache& cache, uint32_t id, size_t length)
+{
+    auto frame = cache.get(id);
+    if (!frame.data || frame.length != length)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (frame.data[i] != static_cast<uint8_t>(id & 0xFF))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_FrameCache_StoresAndFindsFrames(void)
+{
+    FrameCache<128, 8> cache;
+    storeFrame(cache, 10, 5);
+    storeFrame(cache, 11, 9);
+
+    TEST_ASSERT_TRUE(frameIntact(cache, 10, 5));
+    TEST_ASSERT_TRUE(frameIntact(cache, 11, 9));
+    TEST_ASSERT_NULL(cache.get(12).data);
+    TEST_ASSERT_EQUAL_UINT32(2, cache.size());
+}
+
+void test_FrameCache_WrapEvictsOldestOnly(void)
+{
+    FrameCache<64, 16> cache;
+    // 10 byte frames with 16 bytes reserved: 1..5 fill 0..50, and the
+    // sixth no longer fits after them so it wraps to the start
+    for (uint32_t id = 1; id <= 6; ++id)
+    {
+        storeFrame(cache, id, 10);
+    }
+
+    // Only the frames under the sixth and its reserved room are gone
+    TEST_ASSERT_FALSE(cache.contains(1));
+    TEST_ASSERT_FALSE(cache.contains(2));
+    for (uint32_t id = 3; id <= 6; ++id)
+    {
+        TEST_ASSERT_TRUE(frameIntact(cache, id, 10));
+    }
+
+    storeFrame(cache, 7, 10);
+    TEST_ASSERT_FALSE(cache.contains(3));
+    TEST_ASSERT_TRUE(frameIntact(cache, 4, 10));
+    TEST_ASSERT_TRUE(frameIntact(cache, 7, 10));
+}
+
+void test_FrameCache_HeldFramesAreNeverOverwritten(void)
+{
+    FrameCache<100, 6> cache;
+    // Mixed sizes, many laps of the arena: whatever is still held must be
+    // exactly as stored
+    for (uint32_t id = 1; id < 500; ++id)
+    {
+        storeFrame(cache, id, 1 + (id * 7) % 20, 24);
+        for (uint32_t back = 0; back < 6 && back < id; ++back)
+        {
+            uint32_t old = id - back;
+            if (cache.contains(old))
+            {
+                TEST_ASSERT_TRUE(frameIntact(cache, old, 1 + (old * 7) % 20));
+            }
+        }
+        TEST_ASSERT_TRUE(cache.contains(id));
+    }
+    TEST_ASSERT_TRUE(cache.size() <= 6);
+}
+
+void test_FrameCache_SameIdReplacesFrame(void)
+{
+    FrameCache<128, 4> cache;
+    storeFrame(cache, 42, 4);
+    uint8_t* frame = cache.reserve(16);
+    memset(frame, 0x99, 6);
+    cache.commit(42, 6);
+
+    auto held = cache.get(42);
+    TEST_ASSERT_EQUAL(6, held.length);
+    TEST_ASSERT_EQUAL_UINT8(0x99, held.data[0]);
+}
+
+void test_FrameCache_Reset(void)
+{
+    FrameCache<128, 4> cache;
+    storeFrame(cache, 1, 4);
+    cache.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, cache.size());
+    TEST_ASSERT_FALSE(cache.contains(1));
+}
+
+int test_framecache_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_FrameCache_StoresAndFindsFrames);
+    RUN_TEST(test_FrameCache_WrapEvictsOldestOnly);
+    RUN_TEST(test_FrameCache_HeldFramesAreNeverOverwritten);
+    RUN_TEST(test_FrameCache_SameIdReplacesFrame);
+    RUN_TEST(test_FrameCache_Reset);
+    return UNITY_END();
+}
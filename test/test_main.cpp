@@ -7,6 +7,14 @@ extern void test_ringbuffer_suite();
 extern void test_protoframe_suite();
 extern void test_protoserial_suite();
 extern int test_pb_suite();
+extern int test_trace_suite();
+extern int test_cobs_suite();
+extern int test_crc_suite();
+extern int test_spsc_suite();
+extern int test_dedup_suite();
+extern int test_framecache_suite();
+extern int test_retrywheel_suite();
+extern int test_txscheduler_suite();
 
 void setUp(void)
 {
@@ -27,6 +35,14 @@ int main(void)
     test_protoframe_suite();
     test_protoserial_suite();
     test_pb_suite();
+    test_trace_suite();
+    test_cobs_suite();
+    test_crc_suite();
+    test_spsc_suite();
+    test_dedup_suite();
+    test_framecache_suite();
+    test_retrywheel_suite();
+    test_txscheduler_suite();
 
     return UNITY_END();
 }
@@ -5,6 +5,9 @@ using namespace fakeit;
 
 #include "ProtoFrame.h"
 
+#include <algorithm>
+#include <vector>
+
 void test_readFrame_valid_frame()
 {
     Stream* streamPtr = ArduinoFakeMock(Stream);
@@ -69,6 +72,23 @@ void test_readFrame_length_too_large()
     TEST_ASSERT_FALSE(result);
 }
 
+void test_readFrame_small_config_limits_length()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    BasicProtoFrame<ProtoFrameConfigSmall> protoFrame(streamPtr);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    // Fits the default link but not the small one
+    const uint8_t LEN = ProtoFrameConfigSmall::MAX_FRAME_SIZE;
+
+    When(Method(ArduinoFake(Stream), available)).Return(1, 1, 0);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, LEN);
+
+    TEST_ASSERT_FALSE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(8, protoFrame.m_sentFrames.capacity());
+    TEST_ASSERT_TRUE(sizeof(protoFrame) < sizeof(ProtoFrame));
+}
+
 void test_readFrame_wrong_start_byte()
 {
     Stream* streamPtr = ArduinoFakeMock(Stream);
@@ -89,6 +109,372 @@ void test_readFrame_wrong_start_byte()
     TEST_ASSERT_FALSE(result);
 }
 
+void test_readFrame_resyncs_after_false_start()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const size_t DATA_LEN = sizeof(DATA);
+    const uint8_t CRC = crc8.calculate(DATA, DATA_LEN);
+
+    // A stray start byte with a length of 5 swallows the real frame, whose
+    // bytes must be rescanned once the false candidate fails its CRC
+    When(Method(ArduinoFake(Stream), available)).Return(
+        1, 1, 1, 1, 1, 1, 1, 1, 0
+    );
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, 5, START_BYTE, DATA_LEN, DATA[0], DATA[1], CRC, 0x00);
+
+    bool result = protoFrame.readFrame();
+
+    TEST_ASSERT_TRUE(result);
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_resyncs_after_invalid_length()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const size_t DATA_LEN = sizeof(DATA);
+    const uint8_t CRC = crc8.calculate(DATA, DATA_LEN);
+
+    // The rejected length byte is itself the start of the real frame
+    When(Method(ArduinoFake(Stream), available)).Return(
+        1, 1, 1, 1, 1, 1, 0
+    );
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, START_BYTE, DATA_LEN, DATA[0], DATA[1], CRC);
+
+    bool result = protoFrame.readFrame();
+
+    TEST_ASSERT_TRUE(result);
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_cobs_valid_frame()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setFrameFormat(ProtoFrame::FrameFormat::Cobs);
+
+    // COBS([0x08, 0x2A, crc]) followed by the delimiter
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const uint8_t CRC = crc8.calculate(DATA, sizeof(DATA));
+
+    When(Method(ArduinoFake(Stream), available)).Return(1, 1, 1, 1, 1, 0);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(0x04, DATA[0], DATA[1], CRC, COBS::DELIMITER);
+
+    bool result = protoFrame.readFrame();
+
+    TEST_ASSERT_TRUE(result);
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_cobs_resyncs_at_delimiter()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setFrameFormat(ProtoFrame::FrameFormat::Cobs);
+
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const uint8_t CRC = crc8.calculate(DATA, sizeof(DATA));
+
+    // A truncated block is dropped at its delimiter; the next frame is intact
+    When(Method(ArduinoFake(Stream), available)).Return(1, 1, 1, 1, 1, 1, 1, 1, 0);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(0x05, 0x11, COBS::DELIMITER, 0x04, DATA[0], DATA[1], CRC, COBS::DELIMITER);
+
+    bool result = protoFrame.readFrame();
+
+    TEST_ASSERT_TRUE(result);
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_chunked_valid_frame()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setChunkedRead(true);
+
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const size_t DATA_LEN = sizeof(DATA);
+    const uint8_t FRAME[] = {
+        static_cast<uint8_t>(ProtoFrame::START_BYTE), DATA_LEN, DATA[0], DATA[1],
+        crc8.calculate(DATA, DATA_LEN)
+    };
+
+    When(Method(ArduinoFake(Stream), available)).Return(sizeof(FRAME), 0);
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&FRAME](char* buffer, size_t length) {
+            size_t count = length < sizeof(FRAME) ? length : sizeof(FRAME);
+            memcpy(buffer, FRAME, count);
+            return count;
+        });
+
+    bool result = protoFrame.readFrame();
+    TEST_ASSERT_TRUE(result);
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+    Verify(OverloadedMethod(ArduinoFake(Stream), read, int())).Never();
+}
+
+void test_readFrame_chunked_keeps_bytes_after_frame()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setChunkedRead(true);
+
+    // Two back to back frames delivered in a single chunk
+    const uint8_t FIRST[] = {0x08, 0x01};
+    const uint8_t SECOND[] = {0x08, 0x02};
+    const uint8_t FRAMES[] = {
+        static_cast<uint8_t>(ProtoFrame::START_BYTE), sizeof(FIRST), FIRST[0], FIRST[1],
+        crc8.calculate(FIRST, sizeof(FIRST)),
+        static_cast<uint8_t>(ProtoFrame::START_BYTE), sizeof(SECOND), SECOND[0], SECOND[1],
+        crc8.calculate(SECOND, sizeof(SECOND))
+    };
+
+    When(Method(ArduinoFake(Stream), available)).Return(sizeof(FRAMES), 0);
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&FRAMES](char* buffer, size_t length) {
+            size_t count = length < sizeof(FRAMES) ? length : sizeof(FRAMES);
+            memcpy(buffer, FRAMES, count);
+            return count;
+        });
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(1, protoFrame.getLastReceivedMessage().id);
+
+    // Second frame comes from the staging buffer without touching the stream
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(2, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_chunked_resyncs_in_stage()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setChunkedRead(true);
+
+    // The false candidate is fully staged, so it is checked in place and the
+    // real frame rescanned from the same chunk
+    const uint8_t DATA[] = {0x08, 0x2A};
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t FRAME[] = {
+        START_BYTE, 5, START_BYTE, sizeof(DATA), DATA[0], DATA[1],
+        crc8.calculate(DATA, sizeof(DATA)), 0x00
+    };
+
+    When(Method(ArduinoFake(Stream), available)).Return(sizeof(FRAME), 0);
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&FRAME](char* buffer, size_t length) {
+            size_t count = length < sizeof(FRAME) ? length : sizeof(FRAME);
+            memcpy(buffer, FRAME, count);
+            return count;
+        });
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_varint_length_spans_reads()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    BasicProtoFrame<ProtoFrameConfigLarge> protoFrame(streamPtr);
+    protoFrame.setFrameFormat(ProtoFrameFormat::Varint);
+    protoFrame.setChunkedRead(true);
+
+    // id = 42, then an unknown bytes field padding the payload to 200 bytes,
+    // which needs a two byte length
+    std::vector<uint8_t> data = {0x08, 0x2A, 0x7A, 0x80 | 67, 1};
+    data.resize(200, 0x55);
+    std::vector<uint8_t> frame = {static_cast<uint8_t>(ProtoFrame::START_BYTE), 0x80 | 72, 1};
+    frame.insert(frame.end(), data.begin(), data.end());
+    frame.push_back(crc8.calculate(data.data(), data.size()));
+
+    // Two bytes per read, so the length field is split across reads
+    size_t offset = 0;
+    When(Method(ArduinoFake(Stream), available)).AlwaysDo([&]() {
+        return static_cast<int>(frame.size() - offset);
+    });
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&](char* buffer, size_t length) {
+            size_t count = std::min({length, frame.size() - offset, size_t(2)});
+            memcpy(buffer, &frame[offset], count);
+            offset += count;
+            return count;
+        });
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_chunked_crc_mismatch_across_reads()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setChunkedRead(true);
+
+    // The CRC is folded in read by read, so a flipped payload byte in an
+    // earlier read still fails the check at the last one
+    std::vector<uint8_t> data = {0x08, 0x2A, 0x10, 0x01, 0x18, 0x02};
+    std::vector<uint8_t> frame = {static_cast<uint8_t>(ProtoFrame::START_BYTE), static_cast<uint8_t>(data.size())};
+    frame.insert(frame.end(), data.begin(), data.end());
+    frame.push_back(crc8.calculate(data.data(), data.size()));
+    frame[3] ^= 0x01;
+
+    size_t offset = 0;
+    When(Method(ArduinoFake(Stream), available)).AlwaysDo([&]() {
+        return static_cast<int>(frame.size() - offset);
+    });
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&](char* buffer, size_t length) {
+            size_t count = std::min({length, frame.size() - offset, size_t(3)});
+            memcpy(buffer, &frame[offset], count);
+            offset += count;
+            return count;
+        });
+
+    TEST_ASSERT_FALSE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL(0, protoFrame.getReceivedMessageBufferSize());
+}
+
+void test_readFrame_crc32c_integrity()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr, C110PRegion_REGION_UNSPECIFIED, 1000, 3, ProtoFrame::Integrity::Crc32C);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t DATA[] = {0x08, 0x2A};
+    // Four check bytes, least significant first
+    const uint32_t CRC = Crc32C::calculate(DATA, sizeof(DATA));
+
+    When(Method(ArduinoFake(Stream), available)).Return(
+        1, 1, 1, 1, 1, 1, 1, 1, 0
+    );
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, sizeof(DATA), DATA[0], DATA[1],
+                CRC & 0xFF, (CRC >> 8) & 0xFF, (CRC >> 16) & 0xFF, CRC >> 24);
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_UINT32(42, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_crc16_rejects_crc8_frame()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr, C110PRegion_REGION_UNSPECIFIED, 1000, 3, ProtoFrame::Integrity::Crc16);
+    protoFrame.setChunkedRead(true);
+
+    // A CRC-8 frame followed by one more byte still fails the CRC-16 check
+    std::vector<uint8_t> data = {0x08, 0x2A};
+    std::vector<uint8_t> frame = {static_cast<uint8_t>(ProtoFrame::START_BYTE), static_cast<uint8_t>(data.size())};
+    frame.insert(frame.end(), data.begin(), data.end());
+    frame.push_back(crc8.calculate(data.data(), data.size()));
+    frame.push_back(0x00);
+
+    size_t offset = 0;
+    When(Method(ArduinoFake(Stream), available)).AlwaysDo([&]() {
+        return static_cast<int>(frame.size() - offset);
+    });
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&](char* buffer, size_t length) {
+            size_t count = std::min(length, frame.size() - offset);
+            memcpy(buffer, &frame[offset], count);
+            offset += count;
+            return count;
+        });
+
+    TEST_ASSERT_FALSE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL(0, protoFrame.getReceivedMessageBufferSize());
+}
+
+void test_drainFrames_handles_all_complete_frames()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setDrainBudget(SIZE_MAX);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t FIRST[] = {0x08, 0x01};
+    const uint8_t SECOND[] = {0x08, 0x02};
+
+    When(Method(ArduinoFake(Stream), available)).Return(
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0
+    );
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, sizeof(FIRST), FIRST[0], FIRST[1], crc8.calculate(FIRST, sizeof(FIRST)),
+                START_BYTE, sizeof(SECOND), SECOND[0], SECOND[1], crc8.calculate(SECOND, sizeof(SECOND)));
+
+    size_t frames = protoFrame.drainFrames();
+
+    TEST_ASSERT_EQUAL(2, frames);
+    TEST_ASSERT_EQUAL_UINT32(2, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_drainFrames_stops_at_byte_budget()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t FIRST[] = {0x08, 0x01};
+    const uint8_t SECOND[] = {0x08, 0x02};
+
+    // Budget covers exactly the first 5 byte frame
+    protoFrame.setDrainBudget(SIZE_MAX, 5);
+
+    When(Method(ArduinoFake(Stream), available)).AlwaysReturn(1);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, sizeof(FIRST), FIRST[0], FIRST[1], crc8.calculate(FIRST, sizeof(FIRST)),
+                START_BYTE, sizeof(SECOND), SECOND[0], SECOND[1], crc8.calculate(SECOND, sizeof(SECOND)));
+
+    TEST_ASSERT_EQUAL(1, protoFrame.drainFrames());
+    TEST_ASSERT_EQUAL_UINT32(1, protoFrame.getLastReceivedMessage().id);
+    TEST_ASSERT_EQUAL(1, protoFrame.drainFrames());
+    TEST_ASSERT_EQUAL_UINT32(2, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_readFrame_short_frame_does_not_read_clock()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        mutable int clockCalls = 0;
+        uint32_t getSafeTimestamp() const override { clockCalls++; return 0; }
+    } protoFrame(streamPtr);
+
+    const uint8_t START_BYTE = ProtoFrame::START_BYTE;
+    const uint8_t DATA[] = {0x08, 0x2A};
+
+    When(Method(ArduinoFake(Stream), available)).Return(1, 1, 1, 1, 1, 0);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int()))
+        .Return(START_BYTE, sizeof(DATA), DATA[0], DATA[1], crc8.calculate(DATA, sizeof(DATA)));
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.clockCalls);
+}
+
+void test_readFrame_tick_provider_bounds_read_loop()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr, C110PRegion_REGION_UNSPECIFIED, 1000);
+
+    // Every tick jumps past the read budget
+    static uint32_t tick = 0;
+    tick = 0;
+    protoFrame.setTickProvider([]() -> uint32_t { return tick += 2000; }, 1);
+
+    When(Method(ArduinoFake(Stream), available)).AlwaysReturn(1);
+    When(OverloadedMethod(ArduinoFake(Stream), read, int())).AlwaysReturn(0x00);
+
+    TEST_ASSERT_FALSE(protoFrame.readFrame());
+    // First check starts the clock after one byte, the second one trips it
+    Verify(OverloadedMethod(ArduinoFake(Stream), read, int())).Exactly(2);
+}
+
 void test_handleAck_acknowledges_message()
 {
     // Arrange
@@ -96,18 +482,17 @@ void test_handleAck_acknowledges_message()
     ProtoFrame protoFrame(streamPtr);
 
     // Simulate sending a message and storing it in the buffer
-    C110PCommand sentMsg;
+    C110PCommand sentMsg = C110PCommand_init_zero;
     sentMsg.id = 12345;
-    protoFrame.m_sentMessageBuffer.add(sentMsg);
-    protoFrame.m_messageInfoMap[sentMsg.id] = {0, 0};
+    protoFrame.send(sentMsg);
+    protoFrame.trackMessage(sentMsg.id, 0, 0);
 
     // Act
     protoFrame.handleAck(sentMsg.id);
 
     // Assert
-    C110PCommand* msgPtr = protoFrame.m_sentMessageBuffer.get(sentMsg.id);
-    TEST_ASSERT_NOT_NULL(msgPtr);
-    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.m_messageInfoMap.count(sentMsg.id));
+    TEST_ASSERT_TRUE(protoFrame.sentFrames().contains(sentMsg.id));
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(sentMsg.id));
 }
 
 void test_handleAck_message_not_found()
@@ -118,14 +503,14 @@ void test_handleAck_message_not_found()
 
     // No message with this timestamp in buffer
     uint32_t missingTimestamp = 99999;
-    protoFrame.m_messageInfoMap.erase(missingTimestamp);
+    protoFrame.m_pendingMessages.remove(missingTimestamp);
 
     // Act
     protoFrame.handleAck(missingTimestamp);
 
     // Assert
     // Should not crash, and unacknowledgedMessages should remain unchanged
-    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.m_messageInfoMap.count(missingTimestamp));
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(missingTimestamp));
 }
 
 void test_handleNack_message_not_found()
@@ -142,8 +527,7 @@ void test_handleNack_message_not_found()
 
     // Assert
     // Should not crash, nothing to check as nothing should happen
-    C110PCommand* msgPtr = protoFrame.m_sentMessageBuffer.get(missingTimestamp);
-    TEST_ASSERT_NULL(msgPtr);
+    TEST_ASSERT_NULL(protoFrame.sentFrames().get(missingTimestamp).data);
 }
 
 void test_handleNack_message_already_acknowledged()
@@ -152,18 +536,17 @@ void test_handleNack_message_already_acknowledged()
     Stream* streamPtr = ArduinoFakeMock(Stream);
     ProtoFrame protoFrame(streamPtr);
 
-    C110PCommand sentMsg;
+    C110PCommand sentMsg = C110PCommand_init_zero;
     sentMsg.id = 22222;
-    protoFrame.m_sentMessageBuffer.add(sentMsg);
-    protoFrame.m_messageInfoMap[sentMsg.id] = {0, 0};
-    protoFrame.m_messageInfoMap.erase(sentMsg.id);
+    protoFrame.send(sentMsg);
+    protoFrame.trackMessage(sentMsg.id, 0, 0);
+    protoFrame.m_pendingMessages.remove(sentMsg.id);
 
     // Act
     protoFrame.handleNack(sentMsg.id);
 
-    // Assert
-    C110PCommand* msgPtr = protoFrame.m_sentMessageBuffer.get(sentMsg.id);
-    TEST_ASSERT_NOT_NULL(msgPtr);
+    // Assert: nothing written
+    TEST_ASSERT_TRUE(protoFrame.sentFrames().contains(sentMsg.id));
 }
 
 void test_handleNack_message_not_acknowledged_resends_and_sets_processedTimestamp()
@@ -172,20 +555,22 @@ void test_handleNack_message_not_acknowledged_resends_and_sets_processedTimestam
     Stream* streamPtr = ArduinoFakeMock(Stream);
     ProtoFrame protoFrame(streamPtr);
 
-    C110PCommand sentMsg;
+    C110PCommand sentMsg = C110PCommand_init_zero;
     sentMsg.id = 33333;
 
-    protoFrame.m_sentMessageBuffer.add(sentMsg);
-    protoFrame.m_messageInfoMap[sentMsg.id] = {0, 0};
+    protoFrame.send(sentMsg);
+    protoFrame.trackMessage(sentMsg.id, 0, 0);
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).AlwaysDo(
+        [](const uint8_t*, size_t len) { return len; });
 
     // Act
     protoFrame.handleNack(sentMsg.id);
 
     // Assert
-    C110PCommand* msgPtr = protoFrame.m_sentMessageBuffer.get(sentMsg.id);
-    TEST_ASSERT_NOT_NULL(msgPtr);
-    TEST_ASSERT_EQUAL_UINT32(1, protoFrame.m_messageInfoMap.count(sentMsg.id));
-    TEST_ASSERT_NOT_EQUAL_UINT32(0, protoFrame.m_messageInfoMap[sentMsg.id].lastProcessedTimestamp);
+    TEST_ASSERT_TRUE(protoFrame.sentFrames().contains(sentMsg.id));
+    Verify(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).Once();
+    TEST_ASSERT_TRUE(protoFrame.m_pendingMessages.contains(sentMsg.id));
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, protoFrame.m_pendingMessages.find(sentMsg.id)->lastProcessedTimestamp);
 }
 
 void test_sendAck_calls_send_with_correct_message()
@@ -198,11 +583,14 @@ void test_sendAck_calls_send_with_correct_message()
     uint32_t testTimestamp = 123456;
     protoFrame.sendAck(testTimestamp);
 
-    C110PCommand msg = *protoFrame.m_sentMessageBuffer.get(testTimestamp);
+    // Never retried, so not kept in the sent arena
+    TEST_ASSERT_FALSE(protoFrame.sentFrames().contains(testTimestamp));
+    C110PCommand msg = protoFrame.getLastSentMessage();
 
     // Assert
-    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.m_messageInfoMap.count(testTimestamp));
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(testTimestamp));
     TEST_ASSERT_EQUAL_UINT32(testTimestamp, msg.id);
+    TEST_ASSERT_EQUAL(C110PCommand_ack_tag, msg.which_data);
     TEST_ASSERT_TRUE(msg.data.ack.acknowledged);
 }
 
@@ -218,17 +606,156 @@ void test_sendNack_calls_send_with_correct_message_and_reason()
     // Act
     protoFrame.sendNack(testTimestamp, reason);
 
-    C110PCommand msg = *protoFrame.m_sentMessageBuffer.get(testTimestamp);
+    TEST_ASSERT_FALSE(protoFrame.sentFrames().contains(testTimestamp));
+    C110PCommand msg = protoFrame.getLastSentMessage();
 
     // Assert
-    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.m_messageInfoMap.count(testTimestamp));
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(testTimestamp));
     TEST_ASSERT_EQUAL_UINT32(testTimestamp, msg.id);
+    TEST_ASSERT_EQUAL(C110PCommand_ack_tag, msg.which_data);
+    TEST_ASSERT_FALSE(msg.data.ack.acknowledged);
     // Extract the string from pb_callback_t (assuming it is stored in 'arg' as a char*)
     char actual_reason[64] = {0};
     strncpy(actual_reason, msg.data.ack.reason, sizeof(actual_reason) - 1);
     TEST_ASSERT_EQUAL_STRING(reason, actual_reason);
 }
 
+void test_sendAck_coalesces_acks_into_one_batch()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        std::vector<C110PCommand> sent;
+        uint32_t fakeTime = 1000;
+        bool send(const C110PCommand& msg) override
+        {
+            sent.push_back(msg);
+            return true;
+        }
+        uint32_t getSafeTimestamp() const override { return fakeTime; }
+    } protoFrame(streamPtr);
+
+    protoFrame.setAckCoalescing(50, 4);
+    protoFrame.sendAck(5000);
+    protoFrame.sendAck(5020);
+    protoFrame.sendAck(5020);  // A repeat is not queued twice
+    protoFrame.sendAck(4990);
+    TEST_ASSERT_EQUAL(0, protoFrame.sent.size());
+
+    // The fourth fills the batch
+    protoFrame.sendAck(5100);
+    TEST_ASSERT_EQUAL(1, protoFrame.sent.size());
+    const C110PCommand& batch = protoFrame.sent[0];
+    TEST_ASSERT_EQUAL(C110PCommand_ack_batch_tag, batch.which_data);
+    TEST_ASSERT_EQUAL_UINT32(5000, batch.id);
+    TEST_ASSERT_EQUAL(3, batch.data.ack_batch.offsets_count);
+    TEST_ASSERT_EQUAL_INT(20, batch.data.ack_batch.offsets[0]);
+    TEST_ASSERT_EQUAL_INT(-10, batch.data.ack_batch.offsets[1]);
+    TEST_ASSERT_EQUAL_INT(100, batch.data.ack_batch.offsets[2]);
+}
+
+void test_flushDueAcks_waits_for_the_delay()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        std::vector<C110PCommand> sent;
+        uint32_t fakeTime = 1000;
+        bool send(const C110PCommand& msg) override
+        {
+            sent.push_back(msg);
+            return true;
+        }
+        uint32_t getSafeTimestamp() const override { return fakeTime; }
+    } protoFrame(streamPtr);
+
+    protoFrame.setAckCoalescing(50, 8);
+    protoFrame.sendAck(700);
+    protoFrame.fakeTime += 49;
+    protoFrame.flushDueAcks();
+    TEST_ASSERT_EQUAL(0, protoFrame.sent.size());
+
+    // A lone ACK goes out in the plain form
+    protoFrame.fakeTime += 1;
+    protoFrame.flushDueAcks();
+    TEST_ASSERT_EQUAL(1, protoFrame.sent.size());
+    TEST_ASSERT_EQUAL(C110PCommand_ack_tag, protoFrame.sent[0].which_data);
+    TEST_ASSERT_EQUAL_UINT32(700, protoFrame.sent[0].id);
+    TEST_ASSERT_TRUE(protoFrame.sent[0].data.ack.acknowledged);
+
+    protoFrame.flushDueAcks();
+    TEST_ASSERT_EQUAL(1, protoFrame.sent.size());
+}
+
+void test_receiveMessage_ack_batch_clears_every_covered_message()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int sendAckCalled = 0;
+        void sendAck(uint32_t) override { sendAckCalled++; }
+    } protoFrame(streamPtr);
+
+    protoFrame.trackMessage(3000, 3000);
+    protoFrame.trackMessage(3040, 3040);
+    protoFrame.trackMessage(2950, 2950);
+    protoFrame.trackMessage(4000, 4000);
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 3000;
+    msg.which_data = C110PCommand_ack_batch_tag;
+    msg.data.ack_batch.offsets_count = 2;
+    msg.data.ack_batch.offsets[0] = 40;
+    msg.data.ack_batch.offsets[1] = -50;
+
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    TEST_ASSERT_EQUAL_UINT32(1, protoFrame.getUnacknowledgedMessagesSize());
+    TEST_ASSERT_TRUE(protoFrame.m_pendingMessages.contains(4000));
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.sendAckCalled);
+}
+
+void test_receiveMessage_piggyback_ack_clears_message()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        std::vector<uint32_t> acked;
+        void sendAck(uint32_t timestamp) override { acked.push_back(timestamp); }
+    } protoFrame(streamPtr);
+
+    protoFrame.trackMessage(6000, 6000);
+    protoFrame.trackMessage(6010, 6010);
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 9100;
+    msg.source = C110PRegion_REGION_DOME;
+    msg.which_data = C110PCommand_led_tag;
+    msg.piggyback_ack = 6010;
+
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    // The carried ACK is handled, and the command itself is ACKed as usual
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(6010));
+    TEST_ASSERT_TRUE(protoFrame.m_pendingMessages.contains(6000));
+    TEST_ASSERT_EQUAL(1, protoFrame.acked.size());
+    TEST_ASSERT_EQUAL_UINT32(9100, protoFrame.acked[0]);
+}
+
 void test_processCallback_calls_handleAck_when_acknowledged()
 {
     // Arrange
@@ -422,11 +949,11 @@ void test_retryMessages_retries_unacknowledged_messages_after_timeout()
         using ProtoFrame::ProtoFrame;
         int resendCalled = 0;
         uint32_t lastResentTimestamp = 0;
-        void resendMessage(C110PCommand& message) override
+        void resendMessage(uint32_t timestamp) override
         {
             resendCalled++;
-            lastResentTimestamp = message.id;
-            ProtoFrame::resendMessage(message);
+            lastResentTimestamp = timestamp;
+            ProtoFrame::resendMessage(timestamp);
         }
         uint32_t fakeTime = 10000;
         uint32_t getSafeTimestamp() const override { return fakeTime; }
@@ -434,11 +961,14 @@ void test_retryMessages_retries_unacknowledged_messages_after_timeout()
 
     protoFrame.m_messageTimeout = 1000;
 
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 42;
 
-    protoFrame.m_sentMessageBuffer.add(msg);
-    protoFrame.m_messageInfoMap[msg.id] = {8000, 1};
+    protoFrame.send(msg);
+    // Retried once at 7000, so the next retry waits twice the timeout
+    protoFrame.trackMessage(msg.id, 7000, 1);
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).AlwaysDo(
+        [](const uint8_t*, size_t len) { return len; });
 
     // Act
     protoFrame.retryMessages();
@@ -447,9 +977,8 @@ void test_retryMessages_retries_unacknowledged_messages_after_timeout()
     TEST_ASSERT_EQUAL_INT(1, protoFrame.resendCalled);
     TEST_ASSERT_EQUAL_UINT32(42, protoFrame.lastResentTimestamp);
 
-    C110PCommand* updatedMsg = protoFrame.m_sentMessageBuffer.get(msg.id);
-    TEST_ASSERT_NOT_NULL(updatedMsg);
-    TEST_ASSERT_EQUAL_UINT64(protoFrame.fakeTime, protoFrame.m_messageInfoMap[msg.id].lastProcessedTimestamp);
+    TEST_ASSERT_TRUE(protoFrame.sentFrames().contains(msg.id));
+    TEST_ASSERT_EQUAL_UINT64(protoFrame.fakeTime, protoFrame.m_pendingMessages.find(msg.id)->lastProcessedTimestamp);
 }
 
 void test_retryMessages_does_not_retry_acknowledged_messages()
@@ -460,16 +989,16 @@ void test_retryMessages_does_not_retry_acknowledged_messages()
     {
         using ProtoFrame::ProtoFrame;
         int resendCalled = 0;
-        void resendMessage(C110PCommand&) override { resendCalled++; }
+        void resendMessage(uint32_t) override { resendCalled++; }
         uint32_t getSafeTimestamp() const override { return 10000; }
     } protoFrame(streamPtr);
 
     protoFrame.m_messageTimeout = 1000;
 
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 99;
 
-    protoFrame.m_sentMessageBuffer.add(msg);
+    protoFrame.send(msg);
 
     protoFrame.retryMessages();
 
@@ -484,23 +1013,23 @@ void test_retryMessages_does_not_retry_if_timeout_not_reached()
     {
         using ProtoFrame::ProtoFrame;
         int resendCalled = 0;
-        void resendMessage(C110PCommand&) override { resendCalled++; }
+        void resendMessage(uint32_t) override { resendCalled++; }
         uint32_t getSafeTimestamp()const override { return 10000; }
     } protoFrame(streamPtr);
 
     protoFrame.m_messageTimeout = 1000;
 
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 77;
-    protoFrame.m_sentMessageBuffer.add(msg);
-    protoFrame.m_messageInfoMap[msg.id] = {9500, 1};
+    protoFrame.send(msg);
+    protoFrame.trackMessage(msg.id, 9500, 1);
 
     protoFrame.retryMessages();
 
     TEST_ASSERT_EQUAL_INT(0, protoFrame.resendCalled);
 }
 
-void test_resendMessage_sets_processedTimestamp_and_calls_send()
+void test_resendMessage_writes_cached_frame_without_encoding()
 {
     Stream* streamPtr = ArduinoFakeMock(Stream);
 
@@ -508,26 +1037,206 @@ void test_resendMessage_sets_processedTimestamp_and_calls_send()
     {
         using ProtoFrame::ProtoFrame;
         int sendCalled = 0;
-        C110PCommand lastSent;
         uint64_t fakeTime = 12345;
-        bool send(const C110PCommand& msg) override
+        bool send(const C110PCommand&) override
         {
             sendCalled++;
-            lastSent = msg;
             return true;
         }
         uint32_t getSafeTimestamp() const override { return fakeTime; }
     } protoFrame(streamPtr);
 
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 555;
-    protoFrame.m_messageInfoMap[msg.id] = {0, 1}; // 1000ms ago
+    msg.which_data = C110PCommand_led_tag;
+    msg.data.led.start = 7;
+    ProtoFrame::SentFrame cached = protoFrame.encodeFrame(msg);
+    TEST_ASSERT_NOT_NULL(cached.data);
+    protoFrame.trackMessage(msg.id, 0, 1); // 1000ms ago
+
+    std::vector<uint8_t> written;
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).AlwaysDo(
+        [&written](const uint8_t* data, size_t len) {
+            written.insert(written.end(), data, data + len);
+            return len;
+        });
+
+    protoFrame.resendMessage(msg.id);
+
+    // One write of the frame as first built, without going through send()
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.sendCalled);
+    Verify(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).Once();
+    TEST_ASSERT_EQUAL(cached.length, written.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(cached.data, written.data(), cached.length);
+    TEST_ASSERT_EQUAL_UINT64(protoFrame.fakeTime, protoFrame.m_pendingMessages.find(msg.id)->lastProcessedTimestamp);
+    TEST_ASSERT_EQUAL_UINT8(2, protoFrame.m_pendingMessages.find(msg.id)->retryCount);
+}
+
+void test_encodeFrame_round_trips_submessage()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setChunkedRead(true);
+
+    // nanopb writes the move body through a substream of its own, after
+    // the header fields; both must land in order under one crc
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 300;
+    msg.source = C110PRegion_REGION_BODY;
+    msg.target = C110PRegion_REGION_DOME;
+    msg.which_data = C110PCommand_move_tag;
+    msg.data.move.target = C110PActuator_BODY_NECK;
+    msg.data.move.x = 1000;
+    msg.data.move.y = 2;
+    ProtoFrame::SentFrame frame = protoFrame.encodeFrame(msg);
+    TEST_ASSERT_NOT_NULL(frame.data);
+    std::vector<uint8_t> bytes(frame.data, frame.data + frame.length);
+
+    When(Method(ArduinoFake(Stream), available)).Return(bytes.size(), 0);
+    When(OverloadedMethod(ArduinoFake(Stream), readBytes, size_t(char*, size_t)))
+        .AlwaysDo([&bytes](char* buffer, size_t length) {
+            size_t count = std::min(length, bytes.size());
+            memcpy(buffer, bytes.data(), count);
+            return count;
+        });
+
+    TEST_ASSERT_TRUE(protoFrame.readFrame());
+    const C110PCommand received = protoFrame.getLastReceivedMessage();
+    TEST_ASSERT_EQUAL_UINT32(300, received.id);
+    TEST_ASSERT_EQUAL(C110PRegion_REGION_DOME, received.target);
+    TEST_ASSERT_EQUAL(C110PCommand_move_tag, received.which_data);
+    TEST_ASSERT_EQUAL(C110PActuator_BODY_NECK, received.data.move.target);
+    TEST_ASSERT_EQUAL_UINT32(1000, received.data.move.x);
+    TEST_ASSERT_EQUAL_UINT32(2, received.data.move.y);
+}
+
+void test_retryMessages_gives_up_when_frame_was_evicted()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
 
-    protoFrame.resendMessage(msg);
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int resendCalled = 0;
+        void resendMessage(uint32_t) override { resendCalled++; }
+        uint32_t getSafeTimestamp() const override { return 10000; }
+    } protoFrame(streamPtr);
+
+    // Unacknowledged, but no frame held any more to retransmit
+    protoFrame.trackMessage(31337, 0, 0);
+
+    protoFrame.retryMessages();
 
-    TEST_ASSERT_EQUAL_INT(1, protoFrame.sendCalled);
-    TEST_ASSERT_EQUAL_UINT32(555, protoFrame.lastSent.id);
-    TEST_ASSERT_EQUAL_UINT64(protoFrame.fakeTime, protoFrame.m_messageInfoMap[msg.id].lastProcessedTimestamp);
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.resendCalled);
+    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.getUnacknowledgedMessagesSize());
+}
+
+void test_retryMessages_backs_off_then_gives_up()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        uint32_t fakeTime = 0;
+        uint32_t getSafeTimestamp() const override { return fakeTime; }
+    } protoFrame(streamPtr, C110PRegion_REGION_UNSPECIFIED, 1000, 3);
+
+    std::vector<uint32_t> retriedAt;
+    When(OverloadedMethod(ArduinoFake(Stream), write, size_t(const uint8_t*, size_t))).AlwaysDo(
+        [&](const uint8_t*, size_t len) {
+            retriedAt.push_back(protoFrame.fakeTime);
+            return len;
+        });
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 4242;
+    protoFrame.send(msg);
+    protoFrame.trackMessage(msg.id, 0);
+
+    // Polled every 10 ms and never acknowledged
+    for (protoFrame.fakeTime = 0; protoFrame.fakeTime <= 20000; protoFrame.fakeTime += 10)
+    {
+        protoFrame.retryMessages();
+    }
+
+    // Three retries, the wait doubling each time with up to an eighth of
+    // jitter and a wheel tick of lateness, then given up
+    TEST_ASSERT_EQUAL(3, retriedAt.size());
+    uint32_t previous = 0;
+    uint32_t wait = 1000;
+    for (uint32_t at : retriedAt)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(wait, at - previous);
+        TEST_ASSERT_LESS_OR_EQUAL(wait + wait / 8 + 2 * (1u << RETRY_WHEEL_TICK_SHIFT), at - previous);
+        previous = at;
+        wait *= 2;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, protoFrame.getUnacknowledgedMessagesSize());
+}
+
+void test_handleAck_measures_round_trip_per_peer()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        uint32_t fakeTime = 0;
+        uint32_t getSafeTimestamp() const override { return fakeTime; }
+    } protoFrame(streamPtr);
+
+    // Nothing measured yet: the configured timeout
+    TEST_ASSERT_EQUAL_UINT32(1000, protoFrame.retransmitTimeout(C110PRegion_REGION_DOME));
+
+    // The dome answers in 20 ms every time
+    for (uint32_t id = 1; id <= 20; ++id)
+    {
+        protoFrame.fakeTime = id * 100;
+        protoFrame.trackMessage(id, protoFrame.fakeTime, 0, C110PRegion_REGION_DOME);
+        protoFrame.fakeTime += 20;
+        protoFrame.handleAck(id);
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, protoFrame.rtt(C110PRegion_REGION_DOME).srtt());
+    // A steady round trip leaves only the lower bound
+    TEST_ASSERT_EQUAL_UINT32(RTO_MIN_MS, protoFrame.retransmitTimeout(C110PRegion_REGION_DOME));
+    // Other peers are unaffected
+    TEST_ASSERT_FALSE(protoFrame.rtt(C110PRegion_REGION_BODY).sampled());
+    TEST_ASSERT_EQUAL_UINT32(1000, protoFrame.retransmitTimeout(C110PRegion_REGION_BODY));
+
+    // A retried message gives no sample, whichever copy was answered
+    protoFrame.fakeTime = 5000;
+    protoFrame.trackMessage(99, 1000, 1, C110PRegion_REGION_DOME);
+    protoFrame.handleAck(99);
+    TEST_ASSERT_EQUAL_UINT32(20, protoFrame.rtt(C110PRegion_REGION_DOME).srtt());
+    TEST_ASSERT_FALSE(protoFrame.m_pendingMessages.contains(99));
+
+    // A slow, varying peer is held to the upper bound
+    protoFrame.setRetransmitBounds(RTO_MIN_MS, 3000);
+    for (uint32_t id = 100; id <= 110; ++id)
+    {
+        protoFrame.fakeTime = id * 10000;
+        protoFrame.trackMessage(id, protoFrame.fakeTime, 0, C110PRegion_REGION_BODY);
+        protoFrame.fakeTime += (id & 1) ? 500 : 4000;
+        protoFrame.handleAck(id);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3000, protoFrame.retransmitTimeout(C110PRegion_REGION_BODY));
+}
+
+void test_rttEstimator_follows_rfc6298()
+{
+    RttEstimator rtt;
+
+    rtt.sample(100);
+    TEST_ASSERT_EQUAL_UINT32(100, rtt.srtt());
+    TEST_ASSERT_EQUAL_UINT32(50, rtt.rttvar());
+    TEST_ASSERT_EQUAL_UINT32(300, rtt.rto());
+
+    // SRTT += (R - SRTT) / 8, RTTVAR += (|R - SRTT| - RTTVAR) / 4
+    rtt.sample(180);
+    TEST_ASSERT_EQUAL_UINT32(110, rtt.srtt());
+    TEST_ASSERT_EQUAL_UINT32(57, rtt.rttvar());
+    TEST_ASSERT_EQUAL_UINT32(110 + 230, rtt.rto());
 }
 
 void test_receiveMessage_decodes_and_processes_new_message()
@@ -554,7 +1263,7 @@ void test_receiveMessage_decodes_and_processes_new_message()
     } protoFrame(streamPtr);
 
     // Prepare a valid C110PCommand message
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 1234;
     msg.which_data = C110PCommand_led_tag;
     msg.data.led.duration = 10;
@@ -574,7 +1283,34 @@ void test_receiveMessage_decodes_and_processes_new_message()
     TEST_ASSERT_EQUAL_UINT32(1234, protoFrame.lastMsg.id);
     TEST_ASSERT_EQUAL_INT(1, protoFrame.sendAckCalled);
     TEST_ASSERT_EQUAL_UINT32(1234, protoFrame.lastAckTimestamp);
-    TEST_ASSERT_TRUE(protoFrame.m_receivedMessageBuffer.contains(1234));
+    TEST_ASSERT_TRUE(protoFrame.receivedIds(msg.source).contains(1234));
+}
+
+void test_receiveMessage_passes_stored_slot_to_callback()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        const C110PCommand* lastMsg = nullptr;
+        void processCallback(const C110PCommand& msg) override { lastMsg = &msg; }
+        void sendAck(uint32_t) override {}
+    } protoFrame(streamPtr);
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 777;
+    msg.which_data = C110PCommand_led_tag;
+
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    // Decoded in place: the callback sees the stored message, not a copy
+    TEST_ASSERT_NOT_NULL(protoFrame.lastMsg);
+    TEST_ASSERT_EQUAL_PTR(&protoFrame.lastReceived(), protoFrame.lastMsg);
 }
 
 void test_receiveMessage_duplicate_message_only_acks()
@@ -591,12 +1327,12 @@ void test_receiveMessage_duplicate_message_only_acks()
         void sendAck(uint32_t ts) override { sendAckCalled++; lastAckTimestamp = ts; }
     } protoFrame(streamPtr);
 
-    C110PCommand msg;
+    C110PCommand msg = C110PCommand_init_zero;
     msg.id = 4321;
     msg.which_data = C110PCommand_led_tag;
 
-    // Add to received buffer to simulate duplicate
-    protoFrame.m_receivedMessageBuffer.add(msg);
+    // Record the id to simulate duplicate
+    protoFrame.receivedIds(msg.source).check(msg.id);
 
     uint8_t buffer[64];
     pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
@@ -610,6 +1346,140 @@ void test_receiveMessage_duplicate_message_only_acks()
     TEST_ASSERT_EQUAL_UINT32(4321, protoFrame.lastAckTimestamp);
 }
 
+void test_receiveMessage_ack_is_handled_but_not_acked()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int sendAckCalled = 0;
+        int handleAckCalled = 0;
+        void sendAck(uint32_t) override { sendAckCalled++; }
+        void handleAck(uint32_t) override { handleAckCalled++; }
+    } protoFrame(streamPtr);
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 777;
+    msg.which_data = C110PCommand_ack_tag;
+    msg.data.ack.acknowledged = true;
+
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    // Both copies reach handleAck; neither is answered with another ACK
+    TEST_ASSERT_EQUAL_INT(2, protoFrame.handleAckCalled);
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.sendAckCalled);
+}
+
+void test_receiveMessage_best_effort_is_not_acked()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int sendAckCalled = 0;
+        int processCalled = 0;
+        void sendAck(uint32_t) override { sendAckCalled++; }
+        void processCallback(const C110PCommand&) override { processCalled++; }
+    } protoFrame(streamPtr);
+
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 888;
+    msg.source = C110PRegion_REGION_BODY;
+    msg.which_data = C110PCommand_move_tag;
+    msg.qos = C110PQos_QOS_BEST_EFFORT;
+
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    // Run once, and never ACKed, not even as a duplicate
+    TEST_ASSERT_EQUAL_INT(1, protoFrame.processCalled);
+    TEST_ASSERT_EQUAL_INT(0, protoFrame.sendAckCalled);
+}
+
+void test_receiveMessage_duplicate_window_is_per_source()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int processCalled = 0;
+        int sendAckCalled = 0;
+        void processCallback(const C110PCommand&) override { processCalled++; }
+        void sendAck(uint32_t) override { sendAckCalled++; }
+    } protoFrame(streamPtr);
+
+    auto deliver = [&](C110PRegion source, uint32_t id) {
+        C110PCommand msg = C110PCommand_init_zero;
+        msg.id = id;
+        msg.source = source;
+        msg.which_data = C110PCommand_led_tag;
+        uint8_t buffer[64];
+        pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+        TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+        protoFrame.receiveMessage(buffer, ostream.bytes_written);
+    };
+
+    // Two peers whose clocks happen to produce the same id
+    deliver(C110PRegion_REGION_BODY, 5000);
+    deliver(C110PRegion_REGION_DOME, 5000);
+    TEST_ASSERT_EQUAL_INT(2, protoFrame.processCalled);
+
+    // Well past what the old 25 message history remembered
+    for (uint32_t id = 5001; id < 5100; ++id)
+    {
+        deliver(C110PRegion_REGION_BODY, id);
+    }
+    deliver(C110PRegion_REGION_BODY, 5000);
+    TEST_ASSERT_EQUAL_INT(101, protoFrame.processCalled);
+    TEST_ASSERT_EQUAL_INT(102, protoFrame.sendAckCalled);
+    TEST_ASSERT_EQUAL_UINT32(101, protoFrame.getReceivedMessageBufferSize());
+    TEST_ASSERT_EQUAL_UINT32(5099, protoFrame.getLastReceivedMessage().id);
+}
+
+void test_receiveMessage_rebooted_peer_is_run()
+{
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+
+    struct : ProtoFrame
+    {
+        using ProtoFrame::ProtoFrame;
+        int processCalled = 0;
+        int sendAckCalled = 0;
+        void processCallback(const C110PCommand&) override { processCalled++; }
+        void sendAck(uint32_t) override { sendAckCalled++; }
+    } protoFrame(streamPtr);
+
+    protoFrame.receivedIds(C110PRegion_REGION_UNSPECIFIED).check(100000);
+
+    // The peer rebooted 30 s into its clock; its ids now sit below the
+    // window, and every command it sends must still run
+    C110PCommand msg = C110PCommand_init_zero;
+    msg.id = 70000;
+    msg.which_data = C110PCommand_led_tag;
+    uint8_t buffer[64];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(pb_encode(&ostream, C110PCommand_fields, &msg));
+
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+    protoFrame.receiveMessage(buffer, ostream.bytes_written);
+
+    TEST_ASSERT_EQUAL_INT(1, protoFrame.processCalled);
+    TEST_ASSERT_EQUAL_INT(2, protoFrame.sendAckCalled);
+    TEST_ASSERT_EQUAL_UINT32(70000, protoFrame.receivedIds(C110PRegion_REGION_UNSPECIFIED).highest());
+}
+
 void test_receiveMessage_invalid_protobuf_does_nothing()
 {
     Stream* streamPtr = ArduinoFakeMock(Stream);
@@ -639,7 +1509,24 @@ int test_protoframe_suite(void)
     RUN_TEST(test_readFrame_valid_frame);
     RUN_TEST(test_readFrame_invalid_crc);
     RUN_TEST(test_readFrame_length_too_large);
+    RUN_TEST(test_readFrame_small_config_limits_length);
     RUN_TEST(test_readFrame_wrong_start_byte);
+    RUN_TEST(test_readFrame_resyncs_after_false_start);
+    RUN_TEST(test_readFrame_resyncs_after_invalid_length);
+    RUN_TEST(test_readFrame_cobs_valid_frame);
+    RUN_TEST(test_readFrame_cobs_resyncs_at_delimiter);
+    RUN_TEST(test_readFrame_chunked_valid_frame);
+    RUN_TEST(test_readFrame_chunked_keeps_bytes_after_frame);
+    RUN_TEST(test_readFrame_chunked_resyncs_in_stage);
+    RUN_TEST(test_readFrame_varint_length_spans_reads);
+    RUN_TEST(test_readFrame_chunked_crc_mismatch_across_reads);
+    RUN_TEST(test_readFrame_crc32c_integrity);
+    RUN_TEST(test_readFrame_crc16_rejects_crc8_frame);
+
+    RUN_TEST(test_drainFrames_handles_all_complete_frames);
+    RUN_TEST(test_drainFrames_stops_at_byte_budget);
+    RUN_TEST(test_readFrame_short_frame_does_not_read_clock);
+    RUN_TEST(test_readFrame_tick_provider_bounds_read_loop);
 
     RUN_TEST(test_handleAck_acknowledges_message);
     RUN_TEST(test_handleAck_message_not_found);
@@ -652,6 +1539,10 @@ int test_protoframe_suite(void)
     
     RUN_TEST(test_sendNack_calls_send_with_correct_message_and_reason);
 
+    RUN_TEST(test_sendAck_coalesces_acks_into_one_batch);
+    RUN_TEST(test_flushDueAcks_waits_for_the_delay);
+    RUN_TEST(test_receiveMessage_ack_batch_clears_every_covered_message);
+    RUN_TEST(test_receiveMessage_piggyback_ack_clears_message);
     RUN_TEST(test_processCallback_calls_handleAck_when_acknowledged);
     RUN_TEST(test_processCallback_calls_handleNack_when_not_acknowledged);
     RUN_TEST(test_processCallback_calls_LedCallback_when_cmd_led);
@@ -662,9 +1553,19 @@ int test_protoframe_suite(void)
     RUN_TEST(test_retryMessages_retries_unacknowledged_messages_after_timeout);
     RUN_TEST(test_retryMessages_does_not_retry_acknowledged_messages);
     RUN_TEST(test_retryMessages_does_not_retry_if_timeout_not_reached);
-    RUN_TEST(test_resendMessage_sets_processedTimestamp_and_calls_send);
+    RUN_TEST(test_resendMessage_writes_cached_frame_without_encoding);
+    RUN_TEST(test_encodeFrame_round_trips_submessage);
+    RUN_TEST(test_retryMessages_gives_up_when_frame_was_evicted);
+    RUN_TEST(test_retryMessages_backs_off_then_gives_up);
+    RUN_TEST(test_handleAck_measures_round_trip_per_peer);
+    RUN_TEST(test_rttEstimator_follows_rfc6298);
     RUN_TEST(test_receiveMessage_decodes_and_processes_new_message);
+    RUN_TEST(test_receiveMessage_passes_stored_slot_to_callback);
     RUN_TEST(test_receiveMessage_duplicate_message_only_acks);
+    RUN_TEST(test_receiveMessage_ack_is_handled_but_not_acked);
+    RUN_TEST(test_receiveMessage_best_effort_is_not_acked);
+    RUN_TEST(test_receiveMessage_duplicate_window_is_per_source);
+    RUN_TEST(test_receiveMessage_rebooted_peer_is_run);
     RUN_TEST(test_receiveMessage_invalid_protobuf_does_nothing);
 
     return UNITY_END();
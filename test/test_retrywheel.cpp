@@ -0,0 +1,153 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+#include <stdint.h>
+#include <vector>
+
+#include "RetryWheel.h"
+
+using namespace fakeit;
+
+using Wheel = RetryWheel<uint8_t, 8>;
+
+// Ids handed to the callback by one poll, each dropped
+static std::vector<uint32_t> pollDue(Wheel& wheel, uint32_t now)
+{
+    std::vector<uint32_t> due;
+    wheel.poll(now, [&due](uint32_t id, uint8_t&) { due.push_back(id); });
+    return due;
+}
+
+void test_RetryWheel_FiresOnlyWhatIsDue(void)
+{
+    Wheel wheel;
+
+    wheel.schedule(1, 0, 1000);
+    wheel.schedule(2, 0, 1500);
+    wheel.schedule(3, 0, 1200);
+    TEST_ASSERT_TRUE(pollDue(wheel, 900).empty());
+
+    std::vector<uint32_t> due = pollDue(wheel, 1300);
+    TEST_ASSERT_EQUAL(2, due.size());
+    TEST_ASSERT_FALSE(wheel.contains(1));
+    TEST_ASSERT_FALSE(wheel.contains(3));
+    TEST_ASSERT_TRUE(wheel.contains(2));
+    TEST_ASSERT_EQUAL_UINT32(1, wheel.size());
+}
+
+void test_RetryWheel_FiresWithinATickOfTheDeadline(void)
+{
+    Wheel wheel;
+    const uint32_t tick = 1u << RETRY_WHEEL_TICK_SHIFT;
+
+    pollDue(wheel, 0);
+    wheel.schedule(7, 0, 10 * tick + 1);
+    // The deadline's tick has not ended yet
+    TEST_ASSERT_TRUE(pollDue(wheel, 10 * tick + 5).empty());
+    TEST_ASSERT_EQUAL(1, pollDue(wheel, 11 * tick).size());
+}
+
+void test_RetryWheel_RemoveAndValueLookup(void)
+{
+    Wheel wheel;
+
+    wheel.schedule(10, 2, 100);
+    wheel.schedule(11, 5, 100);
+    TEST_ASSERT_EQUAL_UINT8(5, *wheel.find(11));
+    TEST_ASSERT_TRUE(wheel.remove(10));
+    TEST_ASSERT_FALSE(wheel.remove(10));
+    TEST_ASSERT_NULL(wheel.find(10));
+
+    std::vector<uint32_t> due = pollDue(wheel, 200);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL_UINT32(11, due[0]);
+    TEST_ASSERT_TRUE(wheel.empty());
+}
+
+void test_RetryWheel_CallbackReschedules(void)
+{
+    Wheel wheel;
+    int fired = 0;
+
+    wheel.schedule(5, 0, 100);
+    for (uint32_t now = 0; now <= 5000; now += 10)
+    {
+        wheel.poll(now, [&](uint32_t id, uint8_t& retries) {
+            fired++;
+            if (++retries < 3)
+            {
+                wheel.reschedule(id, now + 1000);
+            }
+        });
+    }
+    // Fired three times, then dropped by not rescheduling
+    TEST_ASSERT_EQUAL_INT(3, fired);
+    TEST_ASSERT_TRUE(wheel.empty());
+}
+
+void test_RetryWheel_DeadlineBeyondOneTurn(void)
+{
+    Wheel wheel;
+    const uint32_t turn = RETRY_WHEEL_SLOTS << RETRY_WHEEL_TICK_SHIFT;
+
+    pollDue(wheel, 0);
+    wheel.schedule(9, 0, 3 * turn + 40);
+    // Its slot comes round twice before the deadline
+    for (uint32_t now = 0; now < 3 * turn + 40; now += 7)
+    {
+        TEST_ASSERT_TRUE(pollDue(wheel, now).empty());
+    }
+    TEST_ASSERT_EQUAL(1, pollDue(wheel, 3 * turn + 40 + 2 * (1u << RETRY_WHEEL_TICK_SHIFT)).size());
+}
+
+void test_RetryWheel_OverdueAndLongGaps(void)
+{
+    Wheel wheel;
+
+    pollDue(wheel, 5000);
+    // Already past due when added
+    wheel.schedule(1, 0, 4000);
+    // A gap of many turns between polls
+    wheel.schedule(2, 0, 6000);
+    TEST_ASSERT_EQUAL(2, pollDue(wheel, 500000).size());
+}
+
+void test_RetryWheel_FullDropsTheEarliest(void)
+{
+    Wheel wheel;
+
+    for (uint32_t id = 1; id <= Wheel::capacity(); ++id)
+    {
+        TEST_ASSERT_FALSE(wheel.schedule(id, 0, 1000 + id));
+    }
+    uint32_t evicted = 0;
+    TEST_ASSERT_TRUE(wheel.schedule(100, 0, 3000, &evicted));
+    TEST_ASSERT_EQUAL_UINT32(1, evicted);
+    TEST_ASSERT_FALSE(wheel.contains(1));
+    TEST_ASSERT_TRUE(wheel.contains(100));
+    TEST_ASSERT_EQUAL_UINT32(Wheel::capacity(), wheel.size());
+}
+
+void test_RetryWheel_WrapsAroundZero(void)
+{
+    Wheel wheel;
+
+    pollDue(wheel, 0xFFFFFF00u);
+    wheel.schedule(1, 0, 0xFFFFFF00u + 0x200);
+    TEST_ASSERT_TRUE(pollDue(wheel, 0xFFFFFFF0u).empty());
+    TEST_ASSERT_EQUAL(1, pollDue(wheel, 0x200).size());
+}
+
+int test_retrywheel_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_RetryWheel_FiresOnlyWhatIsDue);
+    RUN_TEST(test_RetryWheel_FiresWithinATickOfTheDeadline);
+    RUN_TEST(test_RetryWheel_RemoveAndValueLookup);
+    RUN_TEST(test_RetryWheel_CallbackReschedules);
+    RUN_TEST(test_RetryWheel_DeadlineBeyondOneTurn);
+    RUN_TEST(test_RetryWheel_OverdueAndLongGaps);
+    RUN_TEST(test_RetryWheel_FullDropsTheEarliest);
+    RUN_TEST(test_RetryWheel_WrapsAroundZero);
+    return UNITY_END();
+}
@@ -126,6 +126,124 @@ void test_PutBehavesLikeAdd(void)
     TEST_ASSERT_EQUAL_STRING("hello", buf.get(42)->data.payload);
 }
 
+void test_PrepareDoesNotTouchStoredMessages(void)
+{
+    RingBuffer<TestMessage> buf;
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE; ++i) {
+        buf.add(TestMessage(i, "x"));
+    }
+
+    // Building a duplicate in place must not clobber anything when full
+    TestMessage& slot = buf.prepare();
+    slot = TestMessage(3, "dup");
+    TEST_ASSERT_FALSE(buf.commit());
+    TEST_ASSERT_NOT_NULL(buf.get(0));
+    TEST_ASSERT_EQUAL_STRING("x", buf.get(3)->data.payload);
+
+    TestMessage& next = buf.prepare();
+    next = TestMessage(99, "new");
+    TEST_ASSERT_TRUE(buf.commit());
+    TEST_ASSERT_EQUAL_PTR(&next, buf.get(99));
+    TEST_ASSERT_FALSE(buf.contains(0));
+    TEST_ASSERT_EQUAL_UINT32(RING_BUFFER_SIZE, buf.size());
+}
+
+void test_DepthIsATemplateParameter(void)
+{
+    RingBuffer<TestMessage, 4> buf;
+    for (uint32_t i = 0; i < 6; ++i) {
+        buf.add(TestMessage(i, "x"));
+    }
+    TEST_ASSERT_EQUAL_UINT32(4u, buf.size());
+    TEST_ASSERT_FALSE(buf.contains(1));
+    TEST_ASSERT_TRUE(buf.contains(2));
+    TEST_ASSERT_EQUAL_UINT32(5u, buf.getCurrentValue().id);
+}
+
+void test_IndexSurvivesChurn(void)
+{
+    // Ids chosen to share index slots, evicted in arbitrary index order
+    RingBuffer<TestMessage, 8> buf;
+    uint32_t ids[200];
+    for (uint32_t i = 0; i < 200; ++i) {
+        ids[i] = (i * 64u) ^ (i % 7);
+        buf.add(TestMessage(ids[i], "x"));
+        for (uint32_t j = 0; j <= i; ++j) {
+            bool held = j + 8 > i;
+            TEST_ASSERT_EQUAL(held, buf.contains(ids[j]));
+            TEST_ASSERT_EQUAL(held, buf.get(ids[j]) != nullptr);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(8u, buf.size());
+}
+
+void test_IteratesOldestToNewestWithoutCopying(void)
+{
+    RingBuffer<TestMessage, 4> buf;
+    TEST_ASSERT_TRUE(buf.begin() == buf.end());
+    for (uint32_t i = 1; i <= 6; ++i) {
+        buf.add(TestMessage(i, "x"));
+    }
+
+    // Wrapped: 3, 4, 5, 6 remain
+    uint32_t expected = 3;
+    for (const TestMessage& msg : buf) {
+        TEST_ASSERT_EQUAL_UINT32(expected, msg.id);
+        TEST_ASSERT_EQUAL_PTR(buf.get(expected), &msg);
+        expected++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(7u, expected);
+
+    const RingBuffer<TestMessage, 4>& view = buf;
+    TEST_ASSERT_EQUAL_PTR(view.get(6), &view.latest());
+    TEST_ASSERT_NULL(view.get(2));
+}
+
+void test_LatestIsEmptyValueWhenEmpty(void)
+{
+    RingBuffer<TestMessage> buf;
+    TEST_ASSERT_TRUE(buf.empty());
+    TEST_ASSERT_EQUAL_UINT32(0u, buf.latest().id);
+    buf.add(TestMessage(7, "seven"));
+    TEST_ASSERT_EQUAL_STRING("seven", buf.latest().data.payload);
+}
+
+void test_ForgetAllowsTheIdAgain(void)
+{
+    RingBuffer<TestMessage, 4> buf;
+    buf.add(TestMessage(1, "old"));
+    buf.add(TestMessage(2, "two"));
+    buf.forget(1);
+    TEST_ASSERT_FALSE(buf.contains(1));
+
+    buf.add(TestMessage(1, "new"));
+    TEST_ASSERT_EQUAL_STRING("new", buf.get(1)->data.payload);
+
+    // Evicting the forgotten slot must leave the newer one indexed
+    buf.add(TestMessage(3, "three"));
+    buf.add(TestMessage(4, "four"));
+    TEST_ASSERT_TRUE(buf.contains(1));
+    TEST_ASSERT_TRUE(buf.contains(2));
+    buf.add(TestMessage(5, "five"));
+    TEST_ASSERT_TRUE(buf.contains(1));
+    TEST_ASSERT_FALSE(buf.contains(2));
+    TEST_ASSERT_EQUAL_STRING("new", buf.get(1)->data.payload);
+}
+
+void test_DropOldest(void)
+{
+    RingBuffer<TestMessage, 4> buf;
+    buf.dropOldest();
+    buf.add(TestMessage(1, "one"));
+    buf.add(TestMessage(2, "two"));
+    TEST_ASSERT_EQUAL_UINT32(1, buf.oldest().id);
+
+    buf.dropOldest();
+    TEST_ASSERT_FALSE(buf.contains(1));
+    TEST_ASSERT_EQUAL_UINT32(1, buf.size());
+    TEST_ASSERT_EQUAL_UINT32(2, buf.oldest().id);
+}
+
 int test_ringbuffer_suite(void)
 {
     UNITY_BEGIN();
@@ -138,6 +256,13 @@ int test_ringbuffer_suite(void)
     RUN_TEST(test_GetCurrentValueReturnsLastAdded);
     RUN_TEST(test_ResetClearsBuffer);
     RUN_TEST(test_PutBehavesLikeAdd);
+    RUN_TEST(test_PrepareDoesNotTouchStoredMessages);
+    RUN_TEST(test_DepthIsATemplateParameter);
+    RUN_TEST(test_IndexSurvivesChurn);
+    RUN_TEST(test_IteratesOldestToNewestWithoutCopying);
+    RUN_TEST(test_LatestIsEmptyValueWhenEmpty);
+    RUN_TEST(test_ForgetAllowsTheIdAgain);
+    RUN_TEST(test_DropOldest);
     
     return UNITY_END();
 }
\ No newline at end of file
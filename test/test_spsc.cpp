@@ -0,0 +1,169 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ProtoFrame.h"
+#include "SpscByteRing.h"
+
+using namespace fakeit;
+
+static const size_t SPSC_STREAM_BYTES = 8 * 1024 * 1024;
+
+void test_Spsc_PushPopWrapsAround(void)
+{
+    SpscByteRing<8> ring;
+    uint8_t out[8];
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    const uint8_t second[] = {7, 8, 9, 10, 11};
+
+    TEST_ASSERT_EQUAL(6, ring.push(first, sizeof(first)));
+    TEST_ASSERT_EQUAL(4, ring.pop(out, 4));
+    // Wraps past the end of the storage on both sides
+    TEST_ASSERT_EQUAL(5, ring.push(second, sizeof(second)));
+    TEST_ASSERT_EQUAL(7, ring.available());
+    TEST_ASSERT_EQUAL(7, ring.pop(out, sizeof(out)));
+    const uint8_t expected[] = {5, 6, 7, 8, 9, 10, 11};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, sizeof(expected));
+    TEST_ASSERT_EQUAL(0, ring.available());
+}
+
+void test_Spsc_FullRingCountsDroppedBytes(void)
+{
+    SpscByteRing<4> ring;
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6};
+
+    TEST_ASSERT_EQUAL(4, ring.push(data, sizeof(data)));
+    TEST_ASSERT_FALSE(ring.push(7));
+    TEST_ASSERT_EQUAL_UINT32(3, ring.dropped());
+}
+
+// A producer thread pushing as fast as it can; the consumer must see every
+// byte exactly once and in order
+void test_Spsc_ProducerThreadLosesNothing(void)
+{
+    static SpscByteRing<4096> ring;
+    std::thread producer([]() {
+        uint8_t chunk[97];
+        size_t sent = 0;
+        while (sent < SPSC_STREAM_BYTES)
+        {
+            size_t count = SPSC_STREAM_BYTES - sent < sizeof(chunk) ? SPSC_STREAM_BYTES - sent : sizeof(chunk);
+            for (size_t i = 0; i < count; ++i)
+            {
+                chunk[i] = static_cast<uint8_t>((sent + i) * 31);
+            }
+            size_t pushed = 0;
+            while (pushed < count)
+            {
+                // Retry instead of dropping so the stream stays complete
+                size_t n = ring.tryPush(chunk + pushed, count - pushed);
+                if (n == 0)
+                {
+                    std::this_thread::yield();
+                }
+                pushed += n;
+            }
+            sent += count;
+        }
+    });
+
+    uint8_t buffer[256];
+    size_t received = 0;
+    size_t mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (received < SPSC_STREAM_BYTES)
+    {
+        size_t count = ring.pop(buffer, sizeof(buffer));
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            mismatches += buffer[i] != static_cast<uint8_t>((received + i) * 31);
+        }
+        received += count;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    producer.join();
+
+    printf("SPSC ring: %zu bytes at %.1f MB/s\n", received, received / seconds / 1e6);
+    TEST_ASSERT_EQUAL(0, mismatches);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+    TEST_ASSERT_EQUAL(0, ring.available());
+}
+
+static std::atomic<uint32_t> s_spscFrames{0};
+
+void test_Spsc_ReadFrameConsumesFromRing(void)
+{
+    static SpscByteRing<1024> ring;
+    Stream* streamPtr = ArduinoFakeMock(Stream);
+    ProtoFrame protoFrame(streamPtr);
+    protoFrame.setRxRing(&ring);
+    protoFrame.setTickProvider([]() -> uint32_t { return 0; });
+    protoFrame.setLedCallback([](const C110PCommand_data_led_MSGTYPE&) { s_spscFrames++; });
+    s_spscFrames = 0;
+
+    const uint32_t FRAMES = 20000;
+    std::thread producer([FRAMES]() {
+        for (uint32_t id = 1; id <= FRAMES; ++id)
+        {
+            uint8_t payload[16];
+            C110PCommand msg = C110PCommand_init_zero;
+            msg.id = id;
+            msg.which_data = C110PCommand_led_tag;
+            msg.data.led.start = id;
+            pb_ostream_t stream = pb_ostream_from_buffer(payload, sizeof(payload));
+            pb_encode(&stream, C110PCommand_fields, &msg);
+            uint8_t frame[sizeof(payload) + 3] = {static_cast<uint8_t>(ProtoFrame::START_BYTE),
+                                                  static_cast<uint8_t>(stream.bytes_written)};
+            memcpy(&frame[2], payload, stream.bytes_written);
+            frame[2 + stream.bytes_written] = crc8.calculate(payload, stream.bytes_written);
+            size_t length = stream.bytes_written + 3;
+            size_t pushed = 0;
+            while (pushed < length)
+            {
+                size_t n = ring.tryPush(frame + pushed, length - pushed);
+                if (n == 0)
+                {
+                    std::this_thread::yield();
+                }
+                pushed += n;
+            }
+        }
+    });
+
+    uint32_t frames = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (frames < FRAMES && std::chrono::steady_clock::now() < deadline)
+    {
+        if (protoFrame.readFrame())
+        {
+            frames++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, frames);
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, s_spscFrames.load());
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, protoFrame.lastReceived().id);
+}
+
+int test_spsc_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Spsc_PushPopWrapsAround);
+    RUN_TEST(test_Spsc_FullRingCountsDroppedBytes);
+    RUN_TEST(test_Spsc_ProducerThreadLosesNothing);
+    RUN_TEST(test_Spsc_ReadFrameConsumesFromRing);
+    return UNITY_END();
+}
@@ -0,0 +1,71 @@
+#include "unity.h"
+
+#include <sstream>
+
+#include "Trace.h"
+
+
+void test_TraceRing_StartsEmpty(void)
+{
+    TraceRing<4> ring;
+    TEST_ASSERT_EQUAL(0, ring.size());
+}
+
+void test_TraceRing_RecordsInOrder(void)
+{
+    TraceRing<4> ring;
+    ring.record(TraceEvent::Sent, 10, 100);
+    ring.record(TraceEvent::AckReceived, 10, 150);
+
+    TEST_ASSERT_EQUAL(2, ring.size());
+    TEST_ASSERT_TRUE(ring.at(0).event == TraceEvent::Sent);
+    TEST_ASSERT_EQUAL_UINT32(10, ring.at(0).msgId);
+    TEST_ASSERT_EQUAL_UINT32(100, ring.at(0).timestamp);
+    TEST_ASSERT_TRUE(ring.at(1).event == TraceEvent::AckReceived);
+    TEST_ASSERT_EQUAL_UINT32(150, ring.at(1).timestamp);
+}
+
+void test_TraceRing_OverwritesOldest(void)
+{
+    TraceRing<4> ring;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        ring.record(TraceEvent::Retry, i, i * 10);
+    }
+
+    TEST_ASSERT_EQUAL(4, ring.size());
+    TEST_ASSERT_EQUAL_UINT32(2, ring.at(0).msgId);
+    TEST_ASSERT_EQUAL_UINT32(5, ring.at(3).msgId);
+}
+
+void test_TraceRing_ClearAndDump(void)
+{
+    TraceRing<4> ring;
+    ring.record(TraceEvent::FrameCrcMismatch, 0, 42);
+
+    std::ostringstream os;
+    ring.dump(os);
+    TEST_ASSERT_EQUAL_STRING("42 event=2 id=0\n", os.str().c_str());
+
+    ring.clear();
+    TEST_ASSERT_EQUAL(0, ring.size());
+}
+
+void test_TraceHex_FormatsBytes(void)
+{
+    const uint8_t data[] = {0x0A, 0xFF, 0x00};
+    std::ostringstream os;
+    os << TraceHex(data, sizeof(data)) << " " << 10;
+    TEST_ASSERT_EQUAL_STRING("0A FF 00 10", os.str().c_str());
+}
+
+int test_trace_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_TraceRing_StartsEmpty);
+    RUN_TEST(test_TraceRing_RecordsInOrder);
+    RUN_TEST(test_TraceRing_OverwritesOldest);
+    RUN_TEST(test_TraceRing_ClearAndDump);
+    RUN_TEST(test_TraceHex_FormatsBytes);
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include <ArduinoFake.h>
+
+#include <stdint.h>
+#include <vector>
+
+#include "TxScheduler.h"
+
+using namespace fakeit;
+
+using Scheduler = TxScheduler<uint32_t, 3, 4>;
+
+// Classes in the order select() serves them, popping each item, until
+// nothing is left
+static std::vector<size_t> drainOrder(Scheduler& scheduler)
+{
+    std::vector<size_t> order;
+    for (size_t cls = scheduler.select(); cls != Scheduler::NONE; cls = scheduler.select())
+    {
+        order.push_back(cls);
+        scheduler.pop(cls);
+    }
+    return order;
+}
+
+void test_TxScheduler_StrictClassGoesFirst(void)
+{
+    Scheduler scheduler;
+    scheduler.setWeight(0, 0);
+
+    scheduler.push(1, 10);
+    scheduler.push(2, 20);
+    scheduler.push(0, 1);
+    scheduler.push(0, 2);
+    TEST_ASSERT_EQUAL(0, scheduler.select());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.front(0));
+    scheduler.pop(0);
+    TEST_ASSERT_EQUAL_UINT32(2, scheduler.front(scheduler.select()));
+    scheduler.pop(0);
+
+    // Arriving mid-round still goes ahead of the weighted classes
+    TEST_ASSERT_EQUAL(1, scheduler.select());
+    scheduler.push(0, 3);
+    TEST_ASSERT_EQUAL(0, scheduler.select());
+}
+
+void test_TxScheduler_SharesByWeight(void)
+{
+    Scheduler scheduler;
+    scheduler.setWeight(1, 3);
+    scheduler.setWeight(2, 1);
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        scheduler.push(1, i);
+        scheduler.push(2, 100 + i);
+    }
+    // Three of class 1 to each one of class 2 while both have work
+    const std::vector<size_t> expected = {1, 1, 1, 2, 1, 2, 2, 2};
+    TEST_ASSERT_TRUE(drainOrder(scheduler) == expected);
+    TEST_ASSERT_TRUE(scheduler.empty());
+}
+
+void test_TxScheduler_FullQueueRefusesOnlyItsClass(void)
+{
+    Scheduler scheduler;
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        TEST_ASSERT_TRUE(scheduler.push(1, i));
+    }
+    TEST_ASSERT_FALSE(scheduler.push(1, 4));
+    TEST_ASSERT_TRUE(scheduler.push(2, 5));
+    TEST_ASSERT_EQUAL(4, scheduler.size(1));
+    TEST_ASSERT_EQUAL(5, scheduler.size());
+
+    // Items come out in the order they went in, across the wrap
+    scheduler.pop(1);
+    TEST_ASSERT_TRUE(scheduler.push(1, 6));
+    std::vector<uint32_t> items;
+    while (scheduler.size(1) > 0)
+    {
+        items.push_back(scheduler.front(1));
+        scheduler.pop(1);
+    }
+    const std::vector<uint32_t> expected = {1, 2, 3, 6};
+    TEST_ASSERT_TRUE(items == expected);
+}
+
+void test_TxScheduler_FindAndClear(void)
+{
+    Scheduler scheduler;
+
+    scheduler.push(1, 7);
+    scheduler.push(1, 8);
+    uint32_t* found = scheduler.find(1, [](uint32_t item) { return item == 8; });
+    TEST_ASSERT_NOT_NULL(found);
+    *found = 9;
+    scheduler.pop(1);
+    TEST_ASSERT_EQUAL_UINT32(9, scheduler.front(1));
+    TEST_ASSERT_NULL(scheduler.find(2, [](uint32_t item) { return item == 9; }));
+
+    scheduler.clear();
+    TEST_ASSERT_TRUE(scheduler.empty());
+    TEST_ASSERT_EQUAL(Scheduler::NONE, scheduler.select());
+}
+
+void test_TxScheduler_DepthZeroHoldsNothing(void)
+{
+    TxScheduler<uint32_t, 3, 0> scheduler;
+
+    TEST_ASSERT_FALSE(scheduler.push(0, 7));
+    TEST_ASSERT_TRUE(scheduler.empty());
+    TEST_ASSERT_EQUAL(0, scheduler.size(0));
+    TEST_ASSERT_EQUAL((TxScheduler<uint32_t, 3, 0>::NONE), scheduler.select());
+    TEST_ASSERT_TRUE(sizeof(scheduler) <= 1);
+}
+
+int test_txscheduler_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_TxScheduler_StrictClassGoesFirst);
+    RUN_TEST(test_TxScheduler_SharesByWeight);
+    RUN_TEST(test_TxScheduler_FullQueueRefusesOnlyItsClass);
+    RUN_TEST(test_TxScheduler_FindAndClear);
+    RUN_TEST(test_TxScheduler_DepthZeroHoldsNothing);
+    return UNITY_END();
+}